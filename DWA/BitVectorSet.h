@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright (c) 2020 Philipp Schubert.
+ * All rights reserved. This program and the accompanying materials are made
+ * available under the terms of LICENSE.txt.
+ *
+ * Contributors:
+ *     Philipp Schubert and others
+ *****************************************************************************/
+
+/*
+ * BitVectorSet.h
+ *
+ * Replaces phasar/Utils/BitVectorSet.h: the same set, with the static index
+ * of the facts safe to use from several threads.
+ */
+
+#ifndef PHASAR_UTILS_BITVECTORSET_H_
+#define PHASAR_UTILS_BITVECTORSET_H_
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <shared_mutex>
+#include <vector>
+
+#include "boost/bimap.hpp"
+
+// Lets IntraMonoSolver run the problem's lattice operations in parallel
+#define PHASAR_BITVECTORSET_THREADSAFE
+
+namespace psr {
+
+/**
+ * BitVectorSet implements a set that requires minimal space. Elements are
+ * stored in a bitvector and the mapping between elements and bits is kept
+ * in a static bimap. A fact keeps its position once it has one, so
+ * lookups share IndexMtx and only the insertion of a new fact takes it
+ * alone; the bits of one set are not guarded.
+ */
+template <typename T> class BitVectorSet {
+private:
+  using bimap_t = boost::bimap<T, size_t>;
+  inline static bimap_t Position;
+  inline static std::shared_mutex IndexMtx;
+
+  std::vector<bool> Bits;
+
+  static size_t positionOf(const T &Data) {
+    {
+      std::shared_lock<std::shared_mutex> Lock(IndexMtx);
+      auto Search = Position.left.find(Data);
+      if (Search != Position.left.end())
+        return Search->second;
+    }
+    std::unique_lock<std::shared_mutex> Lock(IndexMtx);
+    auto Search = Position.left.find(Data);
+    if (Search != Position.left.end())
+      return Search->second;
+    size_t Idx = Position.size();
+    Position.insert(typename bimap_t::value_type(Data, Idx));
+    return Idx;
+  }
+
+  // Position of Data, false if no set ever held it
+  static bool findPosition(const T &Data, size_t &Idx) {
+    std::shared_lock<std::shared_mutex> Lock(IndexMtx);
+    auto Search = Position.left.find(Data);
+    if (Search == Position.left.end())
+      return false;
+    Idx = Search->second;
+    return true;
+  }
+
+  static T factAt(size_t Idx) {
+    std::shared_lock<std::shared_mutex> Lock(IndexMtx);
+    return Position.right.at(Idx);
+  }
+
+public:
+  // Walks the set bits, the facts are looked up as they are read
+  class const_iterator {
+    const std::vector<bool> *Bits = nullptr;
+    size_t Idx = 0;
+
+    void skip() {
+      while (Idx < Bits->size() && !(*Bits)[Idx])
+        ++Idx;
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = T;
+
+    const_iterator() = default;
+    const_iterator(const std::vector<bool> *Bits, size_t Idx)
+        : Bits(Bits), Idx(Idx) {
+      skip();
+    }
+
+    T operator*() const { return factAt(Idx); }
+    const_iterator &operator++() {
+      ++Idx;
+      skip();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator Old = *this;
+      ++*this;
+      return Old;
+    }
+    bool operator==(const const_iterator &Other) const {
+      return Idx == Other.Idx;
+    }
+    bool operator!=(const const_iterator &Other) const {
+      return !(*this == Other);
+    }
+  };
+  using iterator = const_iterator;
+
+  BitVectorSet() = default;
+
+  BitVectorSet(std::initializer_list<T> Ilist) {
+    for (auto &Item : Ilist)
+      insert(Item);
+  }
+
+  template <typename InputIt> BitVectorSet(InputIt First, InputIt Last) {
+    insert(First, Last);
+  }
+
+  ~BitVectorSet() = default;
+
+  BitVectorSet<T> setUnion(const BitVectorSet<T> &Other) const {
+    BitVectorSet<T> Res = *this;
+    Res.insert(Other);
+    return Res;
+  }
+
+  BitVectorSet<T> setIntersect(const BitVectorSet<T> &Other) const {
+    BitVectorSet<T> Res;
+    size_t MinSize = std::min(Bits.size(), Other.Bits.size());
+    Res.Bits.resize(MinSize);
+    for (size_t I = 0; I < MinSize; ++I)
+      Res.Bits[I] = Bits[I] && Other.Bits[I];
+    return Res;
+  }
+
+  // Whether every fact of Other is in this set
+  bool includes(const BitVectorSet<T> &Other) const {
+    for (size_t I = 0; I < Other.Bits.size(); ++I)
+      if (Other.Bits[I] && (I >= Bits.size() || !Bits[I]))
+        return false;
+    return true;
+  }
+
+  void insert(const T &Data) {
+    size_t Idx = positionOf(Data);
+    if (Bits.size() <= Idx)
+      Bits.resize(Idx + 1);
+    Bits[Idx] = true;
+  }
+
+  void insert(const BitVectorSet<T> &Other) {
+    if (Bits.size() < Other.Bits.size())
+      Bits.resize(Other.Bits.size());
+    for (size_t I = 0; I < Other.Bits.size(); ++I)
+      if (Other.Bits[I])
+        Bits[I] = true;
+  }
+
+  template <typename InputIt> void insert(InputIt First, InputIt Last) {
+    for (; First != Last; ++First)
+      insert(*First);
+  }
+
+  void erase(const T &Data) noexcept {
+    size_t Idx;
+    if (findPosition(Data, Idx) && Idx < Bits.size())
+      Bits[Idx] = false;
+  }
+
+  void erase(const BitVectorSet<T> &Other) noexcept {
+    size_t MinSize = std::min(Bits.size(), Other.Bits.size());
+    for (size_t I = 0; I < MinSize; ++I)
+      if (Other.Bits[I])
+        Bits[I] = false;
+  }
+
+  void clear() noexcept { Bits.clear(); }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return std::find(Bits.begin(), Bits.end(), true) == Bits.end();
+  }
+
+  [[nodiscard]] bool find(const T &Data) const noexcept {
+    size_t Idx;
+    return findPosition(Data, Idx) && Idx < Bits.size() && Bits[Idx];
+  }
+
+  [[nodiscard]] size_t count(const T &Data) const noexcept {
+    return find(Data) ? 1 : 0;
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return std::count(Bits.begin(), Bits.end(), true);
+  }
+
+  [[nodiscard]] std::set<T> getAsSet() const {
+    return std::set<T>(begin(), end());
+  }
+
+  const_iterator begin() const { return const_iterator(&Bits, 0); }
+  const_iterator end() const { return const_iterator(&Bits, Bits.size()); }
+
+  // Trailing unset bits do not make two sets differ
+  friend bool operator==(const BitVectorSet<T> &Lhs,
+                         const BitVectorSet<T> &Rhs) {
+    return Lhs.includes(Rhs) && Rhs.includes(Lhs);
+  }
+
+  friend bool operator!=(const BitVectorSet<T> &Lhs,
+                         const BitVectorSet<T> &Rhs) {
+    return !(Lhs == Rhs);
+  }
+
+  friend bool operator<(const BitVectorSet<T> &Lhs,
+                        const BitVectorSet<T> &Rhs) {
+    return Lhs.getAsSet() < Rhs.getAsSet();
+  }
+
+  friend std::ostream &operator<<(std::ostream &OS,
+                                  const BitVectorSet<T> &B) {
+    OS << '<';
+    bool First = true;
+    for (const T &Fact : B) {
+      OS << (First ? "" : ", ") << Fact;
+      First = false;
+    }
+    return OS << '>';
+  }
+};
+
+} // namespace psr
+
+#endif
@@ -17,12 +17,21 @@
 #ifndef PHASAR_PHASARLLVM_MONO_SOLVER_INTRAMONOSOLVER_H_
 #define PHASAR_PHASARLLVM_MONO_SOLVER_INTRAMONOSOLVER_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <deque>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <queue>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -55,13 +64,66 @@ inline void stop_instruments() {
 inline void print_time(const char *str, int color=92) {
   outs() << "\033[" << color << "m" << str << ": " << microseconds << " microseconds\n\033[0m";
 }
+
+inline void print_count(const char *str, size_t count, int color=92) {
+  outs() << "\033[" << color << "m" << str << ": " << count << "\n\033[0m";
+}
 //=============//
 
+//=== Threads ===//
+// Default number of solver threads: $DWA_THREADS, 1 when it is unset
+inline unsigned solver_threads() {
+  const char *Env = getenv("DWA_THREADS");
+  int Threads = Env ? atoi(Env) : 0;
+  return Threads > 0 ? Threads : 1;
+}
+//===============//
+
+//=== Fixpoint ===//
+// Per-function worklists instead of the shared one
+// #define SHARDED
+
+// $DWA_SHARDED set to 1 or 0 picks the sharded fixpoint or not, Default
+// when it is unset
+inline bool fixpoint_sharded(bool Default) {
+  const char *Env = getenv("DWA_SHARDED");
+  return Env ? atoi(Env) != 0 : Default;
+}
+
+// Functions of more edges than this are solved in chunks of this many edges
+// by several threads at once
+#define CHUNK_EDGES 1024
+
+// $DWA_WORKLIST=rpo orders the sequential worklist by reverse postorder,
+// anything else keeps it FIFO
+inline bool worklist_rpo() {
+  const char *Env = getenv("DWA_WORKLIST");
+  return Env && string(Env) == "rpo";
+}
+
+// $DWA_VERIFY set: rerun the parallel fixpoint sequentially and compare
+inline bool verify_fixpoint() { return getenv("DWA_VERIFY") != nullptr; }
+//================//
+
 } // abstract namespace for DWA parallelization
 
 namespace psr {
 
-mutex mtx;
+// Whether normalFlow, join and sqSubSetEqual of the problem of a domain may
+// run on several threads at once. They number new facts in the static index
+// of BitVectorSet, which only DWA/BitVectorSet.h, in place of PhASAR's,
+// guards; without it the parallel fixpoints make these calls one at a time.
+// An analysis whose flow functions share other state specializes this to
+// std::false_type.
+template <typename AnalysisDomainTy>
+struct ThreadSafeLattice
+#ifdef PHASAR_BITVECTORSET_THREADSAFE
+    : std::true_type
+#else
+    : std::false_type
+#endif
+{
+};
 
 template <typename AnalysisDomainTy> class IntraMonoSolver {
 public:
@@ -74,72 +136,542 @@ public:
   using i_t = typename AnalysisDomainTy::i_t;
   using c_t = typename AnalysisDomainTy::c_t;
 
+  // Order in which the sequential fixpoint takes edges off its worklist
+  enum class WorklistOrder { FIFO, RPO };
+
 private:
-  set<string>::iterator EPIt;
-  set<string>::iterator EPEnd;
+  // Entry points of a parallel initialization, taken by index
+  std::vector<string> EntryPointList;
+  std::atomic<size_t> NextEntryPoint{0};
 
 protected:
   ProblemTy &IMProblem;
   std::deque<std::pair<n_t, n_t>> Worklist;
   std::unordered_map<n_t, BitVectorSet<d_t>> Analysis;
   const c_t *CFG;
+  unsigned NumThreads; // 1 runs everything on the calling thread
+  WorklistOrder Order;
+  std::atomic<size_t> Iterations{0}; // edges whose flow function ran
+  // Set while several threads run the fixpoint of a lattice that is not
+  // ThreadSafeLattice: the calls into the problem then take LatticeMtx.
+  // Otherwise only the per-node locks and the index of BitVectorSet are
+  // taken.
+  bool SerializeLattice = false;
+  std::mutex LatticeMtx;
+
+  BitVectorSet<d_t> flow(n_t Node, const BitVectorSet<d_t> &In) {
+    unique_lock<mutex> Lock(LatticeMtx, defer_lock);
+    if (SerializeLattice)
+      Lock.lock();
+    return IMProblem.normalFlow(Node, In);
+  }
+
+  // Joins Out into Facts; true if they changed
+  bool joinInto(BitVectorSet<d_t> &Facts, const BitVectorSet<d_t> &Out) {
+    unique_lock<mutex> Lock(LatticeMtx, defer_lock);
+    if (SerializeLattice)
+      Lock.lock();
+    if (IMProblem.sqSubSetEqual(Out, Facts))
+      return false;
+    Facts = IMProblem.join(Facts, Out);
+    return true;
+  }
+
+  //=== Edge index ===
+  // Dense ids of the nodes of a facts map and of their CFG edges. The edges
+  // leaving node i are Begin[i] to Begin[i + 1] - 1. A worklist holds edge
+  // ids, with a bitmap over them to keep each one queued only once, so it
+  // never outgrows the number of edges.
+  struct EdgeIndex {
+    std::unordered_map<n_t, size_t> Id;
+    std::vector<n_t> Node;
+    std::vector<BitVectorSet<d_t> *> Facts; // of each node
+    std::vector<size_t> Begin;
+    std::vector<size_t> Source, Target; // node ids of each edge
+
+    size_t numEdges() const { return Target.size(); }
+
+    // id of the CFG edge from src to dst
+    size_t edge(n_t src, n_t dst) const {
+      size_t S = Id.at(src);
+      size_t D = Id.at(dst);
+      size_t E = Begin[S];
+      while (E < Begin[S + 1] && Target[E] != D)
+        ++E;
+      assert(E < Begin[S + 1] && "worklist edge missing from the CFG");
+      return E;
+    }
+  };
+
+  // The nodes of Facts, and the nodes their edges reach, in reverse
+  // postorder of the CFG: a node comes before its successors but along back
+  // edges. Depth-first from the nodes without predecessors, then from
+  // whatever is left (unreachable cycles).
+  std::vector<n_t>
+  reversePostorder(std::unordered_map<n_t, BitVectorSet<d_t>> const &Facts) {
+    std::unordered_set<n_t> HasPreds;
+    for (auto &Entry : Facts)
+      for (auto Succ : CFG->getSuccsOf(Entry.first))
+        HasPreds.insert(Succ);
+
+    std::vector<n_t> Postorder;
+    std::unordered_set<n_t> Visited;
+    // a node and its successors not visited yet
+    std::vector<std::pair<n_t, std::vector<n_t>>> Stack;
+    auto Visit = [&](n_t Root) {
+      if (!Visited.insert(Root).second)
+        return;
+      Stack.push_back({Root, CFG->getSuccsOf(Root)});
+      while (!Stack.empty()) {
+        if (Stack.back().second.empty()) {
+          Postorder.push_back(Stack.back().first);
+          Stack.pop_back();
+          continue;
+        }
+        n_t Next = Stack.back().second.back();
+        Stack.back().second.pop_back();
+        if (Visited.insert(Next).second)
+          Stack.push_back({Next, CFG->getSuccsOf(Next)});
+      }
+    };
+    for (auto &Entry : Facts)
+      if (!HasPreds.count(Entry.first))
+        Visit(Entry.first);
+    for (auto &Entry : Facts)
+      Visit(Entry.first);
+    return std::vector<n_t>(Postorder.rbegin(), Postorder.rend());
+  }
+
+  // Numbers the nodes of Facts in reverse postorder if Ordered, in the order
+  // of Facts otherwise, then their edges by source node. A node only reached
+  // by an edge gets an empty entry in Facts.
+  EdgeIndex indexEdges(std::unordered_map<n_t, BitVectorSet<d_t>> &Facts,
+                       bool Ordered) {
+    EdgeIndex Index;
+    auto Add = [&Index](n_t N) {
+      if (Index.Id.emplace(N, Index.Node.size()).second)
+        Index.Node.push_back(N);
+    };
+    if (Ordered)
+      for (auto N : reversePostorder(Facts))
+        Add(N);
+    else
+      for (auto &Entry : Facts)
+        Add(Entry.first);
+    // Node grows while its successors are added
+    for (size_t i = 0; i < Index.Node.size(); ++i) {
+      Index.Begin.push_back(Index.Target.size());
+      for (auto Succ : CFG->getSuccsOf(Index.Node[i])) {
+        Add(Succ);
+        Index.Source.push_back(i);
+        Index.Target.push_back(Index.Id[Succ]);
+      }
+    }
+    Index.Begin.push_back(Index.Target.size());
+    // references to the values of the map survive it growing
+    for (auto N : Index.Node)
+      Index.Facts.push_back(&Facts[N]);
+    return Index;
+  }
 
-  void handleEntryPoints(set<string> const &EntryPoints) {
-    while (EPIt != EPEnd) {
-      mtx.lock();
-      if (EPIt == EPEnd) {
-        mtx.unlock();
+  // Sequential fixpoint of Edges over Facts. The worklist is FIFO, or with
+  // WorklistOrder::RPO takes the edge whose source comes first in reverse
+  // postorder, so that a loop body settles before the code after the loop
+  // is visited again.
+  void iterate(std::deque<std::pair<n_t, n_t>> &Edges,
+               std::unordered_map<n_t, BitVectorSet<d_t>> &Facts) {
+    bool Ordered = Order == WorklistOrder::RPO;
+    EdgeIndex Index = indexEdges(Facts, Ordered);
+    std::vector<bool> Queued(Index.numEdges());
+    std::deque<size_t> Fifo;
+    // with the nodes in reverse postorder, the smallest edge id leaves the
+    // first node
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>>
+        Heap;
+    auto Push = [&](size_t E) {
+      if (Queued[E])
+        return;
+      Queued[E] = true;
+      if (Ordered)
+        Heap.push(E);
+      else
+        Fifo.push_back(E);
+    };
+    for (auto &Edge : Edges)
+      Push(Index.edge(Edge.first, Edge.second));
+    Edges.clear();
+
+    size_t Count = 0;
+    while (Ordered ? !Heap.empty() : !Fifo.empty()) {
+      // std::cout << "worklist size: " << Heap.size() + Fifo.size() << "\n";
+      size_t E;
+      if (Ordered) {
+        E = Heap.top();
+        Heap.pop();
+      } else {
+        E = Fifo.front();
+        Fifo.pop_front();
+      }
+      Queued[E] = false;
+      size_t Src = Index.Source[E];
+      size_t Dst = Index.Target[E];
+      ++Count;
+      BitVectorSet<d_t> Out = flow(Index.Node[Src], *Index.Facts[Src]);
+      if (joinInto(*Index.Facts[Dst], Out)) {
+        for (size_t Succ = Index.Begin[Dst]; Succ < Index.Begin[Dst + 1];
+             ++Succ)
+          Push(Succ);
+      }
+    }
+    Iterations += Count;
+  }
+
+  // Joins the flow along edge E of Index into the facts of its target under
+  // the locks of the nodes; true if they changed
+  bool processEdge(EdgeIndex &Index, std::vector<std::mutex> &Locks,
+                   size_t E) {
+    size_t Src = Index.Source[E];
+    size_t Dst = Index.Target[E];
+    BitVectorSet<d_t> In;
+    {
+      lock_guard<mutex> Lock(Locks[Src]);
+      In = *Index.Facts[Src];
+    }
+    // the flow function runs outside of the node locks
+    BitVectorSet<d_t> Out = flow(Index.Node[Src], In);
+    lock_guard<mutex> Lock(Locks[Dst]);
+    return joinInto(*Index.Facts[Dst], Out);
+  }
+
+  //=== Parallel fixpoint ===
+  // The edges of Analysis, one lock per node guarding its facts, and the
+  // shared worklist of edge ids. The map itself is not modified once the
+  // threads start: indexEdges() inserts every node beforehand.
+  EdgeIndex SharedIndex;
+  std::vector<std::mutex> NodeLocks;
+  std::mutex WorklistMtx; // guards SharedEdges, SharedQueued and Active
+  std::condition_variable WorklistCV;
+  std::deque<size_t> SharedEdges;
+  std::vector<bool> SharedQueued;
+  unsigned Active = 0; // edges taken off the worklist but not finished
+
+  void handleEdges() {
+    size_t Count = 0;
+    unique_lock<mutex> Lock(WorklistMtx);
+    while (true) {
+      WorklistCV.wait(Lock,
+                      [this] { return !SharedEdges.empty() || !Active; });
+      // no edge left and none in flight that could add one
+      if (SharedEdges.empty())
         break;
+      size_t E = SharedEdges.front();
+      SharedEdges.pop_front();
+      // the edge reads its source after this, a change of it requeues it
+      SharedQueued[E] = false;
+      ++Active;
+      Lock.unlock();
+
+      bool Changed = processEdge(SharedIndex, NodeLocks, E);
+      ++Count;
+
+      Lock.lock();
+      bool Pushed = false;
+      size_t Dst = SharedIndex.Target[E];
+      if (Changed)
+        for (size_t Succ = SharedIndex.Begin[Dst];
+             Succ < SharedIndex.Begin[Dst + 1]; ++Succ)
+          if (!SharedQueued[Succ]) {
+            SharedQueued[Succ] = true;
+            SharedEdges.push_back(Succ);
+            Pushed = true;
+          }
+      --Active;
+      if (Pushed || !Active)
+        WorklistCV.notify_all();
+    }
+    Iterations += Count;
+  }
+
+  // Threads take edges off the shared worklist and join into Analysis under
+  // the lock of the target node. A node only grows by joins and every change
+  // requeues its successors, so any order of the edges reaches the same MFP
+  // as the sequential loop. The calls into the problem run in parallel when
+  // its lattice is ThreadSafeLattice, one at a time otherwise.
+  void solveParallel() {
+    SharedIndex = indexEdges(Analysis, false);
+    NodeLocks = std::vector<std::mutex>(SharedIndex.Node.size());
+    SharedQueued.assign(SharedIndex.numEdges(), false);
+    for (auto &Edge : Worklist) {
+      size_t E = SharedIndex.edge(Edge.first, Edge.second);
+      if (!SharedQueued[E]) {
+        SharedQueued[E] = true;
+        SharedEdges.push_back(E);
       }
-      string EntryPoint = *EPIt;
-      EPIt++;
-      mtx.unlock();
+    }
+    Worklist.clear();
+    Active = 0;
+
+    vector<thread> threads;
+    for (unsigned i = 0; i < NumThreads; ++i)
+      threads.push_back(thread(&IntraMonoSolver::handleEdges, this));
+    for (auto &th : threads)
+      th.join();
+    SharedIndex = EdgeIndex();
+    NodeLocks.clear();
+    SharedQueued.clear();
+  }
 
+  //=== Sharded fixpoint ===
+  // The edges and facts of one function. Edges of different functions never
+  // meet, so the shards share no lock.
+  struct Shard {
+    std::deque<std::pair<n_t, n_t>> Edges;
+    std::unordered_map<n_t, BitVectorSet<d_t>> Facts;
+    // Chunks of a function of more than CHUNK_EDGES edges run at once and
+    // join under per-node locks; a smaller one is a single task
+    bool Chunked = false;
+    // of a chunked function, set up by solveSharded()
+    EdgeIndex Index;
+    std::vector<std::mutex> Locks;
+    std::unique_ptr<std::atomic<bool>[]> Queued; // by edge id
+  };
+
+  // A function, or edge ids of a chunk of a chunked one
+  struct Task {
+    Shard *Owner = nullptr;
+    std::deque<size_t> Edges;
+  };
+
+  // Tasks of one thread: it takes them from the back, the others steal from
+  // the front
+  struct TaskQueue {
+    std::mutex Mtx;
+    std::deque<Task> Tasks;
+  };
+
+  std::vector<std::unique_ptr<Shard>> Shards;
+  std::vector<TaskQueue> Queues;
+  std::atomic<size_t> PendingTasks{0}; // queued or running
+
+  void initializeShards() {
+    std::unordered_map<n_t, Shard *> ShardOf;
+    for (auto &EntryPoint : IMProblem.getEntryPoints()) {
       auto Function =
           IMProblem.getProjectIRDB()->getFunctionDefinition(EntryPoint);
       auto ControlFlowEdges = CFG->getAllControlFlowEdges(Function);
 
-      //=== Critical section ===
-      mtx.lock();
-      // add all intra-procedural edges to the worklist
-      Worklist.insert(Worklist.begin(), ControlFlowEdges.begin(),
+      auto S = std::make_unique<Shard>();
+      S->Edges.insert(S->Edges.end(), ControlFlowEdges.begin(),
                       ControlFlowEdges.end());
-      // set all analysis information to the empty set
-      for (auto s : CFG->getAllInstructionsOf(Function))
-        Analysis.insert(std::make_pair(s, BitVectorSet<d_t>()));
-      mtx.unlock();
-      //========================
+      for (auto s : CFG->getAllInstructionsOf(Function)) {
+        S->Facts.insert(std::make_pair(s, BitVectorSet<d_t>()));
+        ShardOf[s] = S.get();
+      }
+      S->Chunked = S->Edges.size() > CHUNK_EDGES;
+      Shards.push_back(std::move(S));
+    }
+
+    // insert initial seeds into the shard of their node
+    for (auto &[Node, FlowFacts] : IMProblem.initialSeeds()) {
+      auto It = ShardOf.find(Node);
+      if (It != ShardOf.end())
+        It->second->Facts[Node].insert(FlowFacts);
+      else
+        Analysis[Node].insert(FlowFacts);
     }
   }
 
-  void initialize() {
-    auto EntryPoints = IMProblem.getEntryPoints();
-    EPIt = EntryPoints.begin();
-    EPEnd = EntryPoints.end();
+  void pushTask(unsigned Self, Task &&T) {
+    ++PendingTasks;
+    lock_guard<mutex> Lock(Queues[Self].Mtx);
+    Queues[Self].Tasks.push_back(std::move(T));
+  }
+
+  // Own tasks first, then one stolen from the next thread that has any
+  bool takeTask(unsigned Self, Task &T) {
+    for (unsigned i = 0; i < Queues.size(); ++i) {
+      TaskQueue &Q = Queues[(Self + i) % Queues.size()];
+      lock_guard<mutex> Lock(Q.Mtx);
+      if (Q.Tasks.empty())
+        continue;
+      if (i == 0) {
+        T = std::move(Q.Tasks.back());
+        Q.Tasks.pop_back();
+      } else {
+        T = std::move(Q.Tasks.front());
+        Q.Tasks.pop_front();
+      }
+      return true;
+    }
+    return false;
+  }
+
+  void runTask(Task &T, unsigned Self) {
+    Shard &S = *T.Owner;
+    if (!S.Chunked) {
+      iterate(S.Edges, S.Facts);
+      return;
+    }
+    size_t Count = 0;
+    while (!T.Edges.empty()) {
+      // a chunk that grew gives half of its edges to whoever steals them
+      if (T.Edges.size() > 2 * CHUNK_EDGES) {
+        auto Middle = T.Edges.begin() + T.Edges.size() / 2;
+        Task Half;
+        Half.Owner = &S;
+        Half.Edges.assign(Middle, T.Edges.end());
+        T.Edges.erase(Middle, T.Edges.end());
+        pushTask(Self, std::move(Half));
+      }
+      size_t E = T.Edges.front();
+      T.Edges.pop_front();
+      S.Queued[E] = false;
+      ++Count;
+      if (!processEdge(S.Index, S.Locks, E))
+        continue;
+      size_t Dst = S.Index.Target[E];
+      for (size_t Succ = S.Index.Begin[Dst]; Succ < S.Index.Begin[Dst + 1];
+           ++Succ)
+        if (!S.Queued[Succ].exchange(true))
+          T.Edges.push_back(Succ);
+    }
+    Iterations += Count;
+  }
+
+  void handleTasks(unsigned Self) {
+    Task T;
+    // a task is counted until it is done, so the tasks it pushes keep the
+    // count above zero
+    while (PendingTasks) {
+      if (!takeTask(Self, T)) {
+        this_thread::yield();
+        continue;
+      }
+      runTask(T, Self);
+      --PendingTasks;
+    }
+  }
+
+  // Every function has its own worklist and facts. Threads take whole
+  // functions, or chunks of the large ones, from their own queue and steal
+  // from the others when it is empty. The facts end up in Analysis.
+  void solveSharded() {
+    // the largest functions first, so that they do not start last
+    std::sort(Shards.begin(), Shards.end(), [](auto &A, auto &B) {
+      return A->Edges.size() > B->Edges.size();
+    });
+    Queues = std::vector<TaskQueue>(NumThreads);
+    unsigned Next = 0;
+    for (auto &S : Shards) {
+      if (!S->Chunked) {
+        Task T;
+        T.Owner = S.get();
+        pushTask(Next++ % NumThreads, std::move(T));
+        continue;
+      }
+      S->Index = indexEdges(S->Facts, false);
+      S->Locks = std::vector<std::mutex>(S->Index.Node.size());
+      S->Queued.reset(new std::atomic<bool>[S->Index.numEdges()]);
+      for (size_t E = 0; E < S->Index.numEdges(); ++E)
+        S->Queued[E] = false;
+      Task T;
+      T.Owner = S.get();
+      for (auto &Edge : S->Edges) {
+        size_t E = S->Index.edge(Edge.first, Edge.second);
+        if (S->Queued[E].exchange(true))
+          continue;
+        T.Edges.push_back(E);
+        if (T.Edges.size() == CHUNK_EDGES) {
+          pushTask(Next++ % NumThreads, std::move(T));
+          T = Task();
+          T.Owner = S.get();
+        }
+      }
+      S->Edges.clear();
+      if (!T.Edges.empty())
+        pushTask(Next++ % NumThreads, std::move(T));
+    }
 
-#define NUM_THREADS 2
-// #define PARALLEL
-#ifdef PARALLEL
-    // Parallelize intraprocedural worklist init
     vector<thread> threads;
-    for (int i = 0; i < NUM_THREADS; ++i)
-      threads.push_back(thread(&IntraMonoSolver::handleEntryPoints, this, EntryPoints));
+    for (unsigned i = 0; i < NumThreads; ++i)
+      threads.push_back(thread(&IntraMonoSolver::handleTasks, this, i));
     for (auto &th : threads)
       th.join();
-#else
-    for (auto &EntryPoint: EntryPoints) {
+
+    for (auto &S : Shards)
+      for (auto &Entry : S->Facts)
+        Analysis[Entry.first] = std::move(Entry.second);
+    Shards.clear();
+    Queues.clear();
+  }
+  //========================
+
+  // Number of nodes whose result differs from the sequential FIFO one
+  size_t countMismatches(std::deque<std::pair<n_t, n_t>> Edges,
+                         std::unordered_map<n_t, BitVectorSet<d_t>> Facts) {
+    WorklistOrder Solved = Order;
+    size_t Counted = Iterations;
+    Order = WorklistOrder::FIFO;
+    iterate(Edges, Facts);
+    Order = Solved;
+    Iterations = Counted;
+    size_t Mismatches = 0;
+    for (auto &[Node, Expected] : Facts)
+      if (!(Analysis[Node] == Expected))
+        ++Mismatches;
+    return Mismatches;
+  }
+  //=========================
+
+  // What one thread of initialize() found, merged once all are done
+  struct InitBuffer {
+    std::vector<std::pair<n_t, n_t>> Edges;
+    std::vector<n_t> Nodes;
+  };
+
+  void handleEntryPoints(InitBuffer &Buffer) {
+    for (size_t i = NextEntryPoint++; i < EntryPointList.size();
+         i = NextEntryPoint++) {
       auto Function =
-          IMProblem.getProjectIRDB()->getFunctionDefinition(EntryPoint);
+          IMProblem.getProjectIRDB()->getFunctionDefinition(EntryPointList[i]);
       auto ControlFlowEdges = CFG->getAllControlFlowEdges(Function);
+      Buffer.Edges.insert(Buffer.Edges.end(), ControlFlowEdges.begin(),
+                          ControlFlowEdges.end());
+      for (auto s : CFG->getAllInstructionsOf(Function))
+        Buffer.Nodes.push_back(s);
+    }
+  }
 
+  void initialize() {
+    auto EntryPoints = IMProblem.getEntryPoints();
+    EntryPointList.assign(EntryPoints.begin(), EntryPoints.end());
+    NextEntryPoint = 0;
+
+    // Parallelize intraprocedural worklist init: the threads share no lock,
+    // each one takes the next entry point off an atomic index
+    size_t NumBuffers = std::min<size_t>(
+        NumThreads, std::max<size_t>(EntryPointList.size(), 1));
+    std::vector<InitBuffer> Buffers(NumBuffers);
+    vector<thread> threads;
+    for (size_t i = 1; i < NumBuffers; ++i)
+      threads.push_back(thread(&IntraMonoSolver::handleEntryPoints, this,
+                               std::ref(Buffers[i])));
+    handleEntryPoints(Buffers[0]);
+    for (auto &th : threads)
+      th.join();
+
+    size_t NumNodes = 0;
+    for (auto &Buffer : Buffers)
+      NumNodes += Buffer.Nodes.size();
+    Analysis.reserve(Analysis.size() + NumNodes);
+    for (auto &Buffer : Buffers) {
       // add all intra-procedural edges to the worklist
-      Worklist.insert(Worklist.begin(), ControlFlowEdges.begin(),
-                      ControlFlowEdges.end());
+      Worklist.insert(Worklist.end(), Buffer.Edges.begin(), Buffer.Edges.end());
       // set all analysis information to the empty set
-      for (auto s : CFG->getAllInstructionsOf(Function))
+      for (auto s : Buffer.Nodes)
         Analysis.insert(std::make_pair(s, BitVectorSet<d_t>()));
     }
-#endif
+    EntryPointList.clear();
 
     // insert initial seeds
     for (auto &[Node, FlowFacts] : IMProblem.initialSeeds()) {
@@ -148,29 +680,69 @@ protected:
   }
 
 public:
-  IntraMonoSolver(ProblemTy &IMP) : IMProblem(IMP), CFG(IMP.getCFG()) {}
+  IntraMonoSolver(ProblemTy &IMP, unsigned Threads = solver_threads())
+      : IMProblem(IMP), CFG(IMP.getCFG()), NumThreads(std::max(Threads, 1u)),
+        Order(worklist_rpo() ? WorklistOrder::RPO : WorklistOrder::FIFO) {}
   virtual ~IntraMonoSolver() = default;
 
+  void setNumThreads(unsigned N) { NumThreads = std::max(N, 1u); }
+  unsigned getNumThreads() const { return NumThreads; }
+  // Only the sequential loops follow it: one thread, or the functions of the
+  // sharded fixpoint that are not cut into chunks
+  void setWorklistOrder(WorklistOrder O) { Order = O; }
+  size_t getIterations() const { return Iterations; }
+
   virtual void solve() {
+#ifdef SHARDED
+    bool Sharded = fixpoint_sharded(true);
+#else
+    bool Sharded = fixpoint_sharded(false);
+#endif
     // step 1: Initalization (of Worklist and Analysis)
     start_instruments();
-    initialize();
+    if (Sharded)
+      initializeShards();
+    else
+      initialize();
     stop_instruments();
     print_time("Init");
     // step 2: Iteration (updating Worklist and Analysis)
-    while (!Worklist.empty()) {
-      // std::cout << "worklist size: " << Worklist.size() << "\n";
-      std::pair<n_t, n_t> path = Worklist.front();
-      Worklist.pop_front();
-      n_t src = path.first;
-      n_t dst = path.second;
-      BitVectorSet<d_t> Out = IMProblem.normalFlow(src, Analysis[src]);
-      if (!IMProblem.sqSubSetEqual(Out, Analysis[dst])) {
-        Analysis[dst] = IMProblem.join(Analysis[dst], Out);
-        for (auto nprimeprime : CFG->getSuccsOf(dst))
-          Worklist.push_back({dst, nprimeprime});
+    bool Verify = (NumThreads > 1 || Sharded || Order != WorklistOrder::FIFO) &&
+                  verify_fixpoint();
+    std::deque<std::pair<n_t, n_t>> InitialWorklist;
+    std::unordered_map<n_t, BitVectorSet<d_t>> InitialAnalysis;
+    if (Verify) {
+      InitialWorklist = Worklist;
+      InitialAnalysis = Analysis;
+      for (auto &S : Shards) {
+        InitialWorklist.insert(InitialWorklist.end(), S->Edges.begin(),
+                               S->Edges.end());
+        InitialAnalysis.insert(S->Facts.begin(), S->Facts.end());
       }
     }
+    Iterations = 0;
+    SerializeLattice =
+        NumThreads > 1 && !ThreadSafeLattice<AnalysisDomainTy>::value;
+    if (SerializeLattice)
+      outs() << "\033[93mBitVectorSet is not thread-safe, flow functions run "
+                "one at a time (install DWA/BitVectorSet.h)\n\033[0m";
+    start_instruments();
+    if (Sharded)
+      solveSharded();
+    else if (NumThreads > 1)
+      solveParallel();
+    else
+      iterate(Worklist, Analysis);
+    stop_instruments();
+    SerializeLattice = false;
+    print_time("Fixpoint");
+    print_count("Iterations", Iterations);
+    if (Verify) {
+      size_t Mismatches = countMismatches(std::move(InitialWorklist),
+                                          std::move(InitialAnalysis));
+      outs() << "\033[" << (Mismatches ? 91 : 92) << "mVerify: " << Mismatches
+             << " nodes differ from the sequential fixpoint\n\033[0m";
+    }
     // step 3: Presenting the result (MFP_in and MFP_out)
     // MFP_in[s] = Analysis[s];
     // MFP out[s] = IMProblem.flow(Analysis[s]);
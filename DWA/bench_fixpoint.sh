@@ -0,0 +1,46 @@
+#!/bin/bash
+# Fixpoint time and iterations against thread count, or another setting.
+# Usage: bench_fixpoint.sh [IR_LIST] [VALUES...]
+#   IR_LIST has lines "path.ll: function count" (ir_sorted_by_func_count.txt),
+#   paths under /Users/ivankor/phasar are looked for under $PHASAR_DIR.
+#   Each file runs once per value of $VAR (DWA_THREADS by default, values
+#   1 2 4 8) with $DWA_VERIFY set, a run whose result differs from the
+#   sequential FIFO fixpoint is reported. The totals are compared with those
+#   of the first value.
+
+LIST=${1:-$(dirname $0)/ir_sorted_by_func_count.txt}
+shift
+VAR=${VAR:-DWA_THREADS}
+VALUES=${@:-1 2 4 8}
+ANALYSIS=${ANALYSIS:-intra-mono-fca}
+PHASAR_DIR=${PHASAR_DIR:-/Users/ivankor/phasar}
+
+declare -A TOTAL ITERATIONS
+printf "%-60s %6s" "file" "funcs"
+for V in $VALUES; do printf " %10s %10s" "$V (us)" "$V (iter)"; done
+echo
+while IFS=: read -r FILE FUNCS; do
+  FILE=${FILE/#\/Users\/ivankor\/phasar/$PHASAR_DIR}
+  [ -f "$FILE" ] || { echo "missing $FILE" >&2; continue; }
+  printf "%-60s %6s" "$(basename $FILE)" $FUNCS
+  for V in $VALUES; do
+    OUT=$(env $VAR=$V DWA_VERIFY=1 phasar-llvm -m "$FILE" -D $ANALYSIS 2>&1)
+    US=$(echo "$OUT" | sed -n 's/.*Fixpoint: \([0-9]*\) microseconds.*/\1/p')
+    IT=$(echo "$OUT" | sed -n 's/.*Iterations: \([0-9]*\).*/\1/p')
+    echo "$OUT" | grep -q "Verify: [1-9]" && echo "MISMATCH $FILE $V" >&2
+    TOTAL[$V]=$(( ${TOTAL[$V]:-0} + ${US:-0} ))
+    ITERATIONS[$V]=$(( ${ITERATIONS[$V]:-0} + ${IT:-0} ))
+    printf " %10s %10s" ${US:--} ${IT:--}
+  done
+  echo
+done < "$LIST"
+
+FIRST=${VALUES%% *}
+echo
+printf "%12s %14s %8s %12s %10s\n" $VAR "fixpoint (us)" speedup iterations saved
+for V in $VALUES; do
+  printf "%12s %14s %8s %12s %10s\n" $V ${TOTAL[$V]} \
+    $(awk "BEGIN {printf \"%.2f\", ${TOTAL[$V]} ? ${TOTAL[$FIRST]} / ${TOTAL[$V]} : 0}") \
+    ${ITERATIONS[$V]} \
+    $(awk "BEGIN {printf \"%.1f%%\", ${ITERATIONS[$FIRST]} ? 100 - 100 * ${ITERATIONS[$V]} / ${ITERATIONS[$FIRST]} : 0}")
+done
@@ -1,37 +1,260 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <random>
+#include <string>
 #include "Board.hpp"
+#include "Endgame.hpp"
+#include "MCTS.hpp"
+#include "OpeningBook.hpp"
+#include "PatternEval.hpp"
+#include "Search.hpp"
+#include "Stats.hpp"
 
 #ifndef __AGENT_HPP
 #define __AGENT_HPP
 
 using namespace std;
 
+enum Strategy {HUMAN, RANDOM, GREEDY, SEARCH, UCT};
+
+// How an agent plays, parsed from "human", "random", "greedy[:EMPTIES]",
+// "search:DEPTH[:EMPTIES]" or "mcts:PLAYOUTS[:THREADS]"
+struct AgentSpec
+{
+    Strategy strategy;
+    int depth; // SEARCH only
+    int moveTimeMs; // SEARCH and UCT, 0 for no limit
+    int threads; // SEARCH and UCT
+    int endgameEmpties; // GREEDY and SEARCH solve from this many empties on
+    int playouts; // UCT only
+
+    static bool parse(const string &name, AgentSpec &spec) {
+        spec = AgentSpec{HUMAN, 0, 0, 1, 0, 0};
+        size_t colon = name.find(':');
+        string strategy = name.substr(0, colon);
+        const char *args = colon == string::npos ? ""
+                                                 : name.c_str() + colon + 1;
+        if (strategy == "human" && !*args) {
+            spec.strategy = HUMAN;
+        } else if (strategy == "random" && !*args) {
+            spec.strategy = RANDOM;
+        } else if (strategy == "greedy") {
+            spec.strategy = GREEDY;
+            spec.endgameEmpties = *args ? atoi(args) : ENDGAME_DEFAULT_EMPTIES;
+        } else if (strategy == "search") {
+            spec.strategy = SEARCH;
+            spec.depth = atoi(args);
+            const char *empties = strchr(args, ':');
+            spec.endgameEmpties = empties ? atoi(empties + 1)
+                                          : ENDGAME_DEFAULT_EMPTIES;
+            return spec.depth > 0;
+        } else if (strategy == "mcts") {
+            spec.strategy = UCT;
+            spec.playouts = atoi(args);
+            const char *threads = strchr(args, ':');
+            spec.threads = threads ? atoi(threads + 1) : 1;
+            return spec.playouts > 0 && spec.threads > 0;
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
 class Agent
 {
     OthelloBoard &board;
-    bool AI; // true for AI, false for human
+    AgentSpec spec;
+    bool verbose; // print the moves and the search statistics
+    minstd_rand rng; // RANDOM only
+    TranspositionTable table;
+    Search search;
+    EndgameSolver solver;
+    MCTS mcts;
+    const OpeningBook *book; // GREEDY and SEARCH, optional
+    GameStats stats;
+
+    // What the phase that chose the move did, counters of the table taken
+    // since before
+    void record(MoveReport &move, const char *phase, double seconds,
+                long long ttProbes, long long ttHits) {
+        move.phase = phase;
+        move.thinkSeconds = seconds - move.bookSeconds;
+        move.ttProbes = table.getProbes() - ttProbes;
+        move.ttHits = table.getHits() - ttHits;
+        if (move.phase == "search") {
+            const SearchCounters &counters = search.getCounters();
+            move.nodes = search.getNodes();
+            move.expanded = counters.expanded;
+            move.movesGenerated = counters.movesGenerated;
+            move.evaluations = counters.evaluations;
+            move.depth = search.getCompletedDepth();
+            move.threads = search.getThreads();
+        } else if (move.phase == "endgame") {
+            move.nodes = solver.getNodes();
+            move.depth = move.empties;
+        } else if (move.phase == "mcts") {
+            move.nodes = mcts.getPlayouts();
+            move.threads = mcts.getThreads();
+        }
+        stats.add(move);
+    }
 public:
     Agent() = delete;
-    Agent(bool AI, OthelloBoard &board) : AI(AI), board(board) {}; // true for AI, false for human
+    // true for AI, false for human; depth > 0 searches for up to moveTimeMs
+    // (0 for no limit) on threads threads instead of playing greedy. The AI
+    // plays the last ENDGAME_DEFAULT_EMPTIES moves perfectly.
+    Agent(bool AI, OthelloBoard &board, int depth=0, int moveTimeMs=0,
+          int threads=1, const OpeningBook *book=nullptr,
+          const PatternEval *eval=nullptr)
+        : Agent(AgentSpec{!AI ? HUMAN : depth > 0 ? SEARCH : GREEDY, depth,
+                          moveTimeMs, threads,
+                          AI ? ENDGAME_DEFAULT_EMPTIES : 0, 0},
+                board, true, 0, book, eval) {};
+    // book and eval are optional, eval is the evaluation of SEARCH
+    Agent(const AgentSpec &spec, OthelloBoard &board, bool verbose=false,
+          unsigned seed=0, const OpeningBook *book=nullptr,
+          const PatternEval *eval=nullptr)
+        : board(board), spec(spec), verbose(verbose), rng(seed),
+          table(spec.strategy == SEARCH ? TT_DEFAULT_MB : 0),
+          search(spec.depth, spec.moveTimeMs, &table, spec.threads, eval),
+          solver(spec.endgameEmpties),
+          mcts(spec.playouts, spec.moveTimeMs, spec.threads, seed,
+               spec.strategy == UCT ? MCTS_DEFAULT_NODES : 1),
+          book(book) {};
     ~Agent() {}
+    // Setting *stop makes a SEARCH or UCT agent play its best move so far;
+    // the book and the endgame solver are quick enough to be left alone
+    void setStop(std::atomic<bool> *stop) {
+        search.setStop(stop);
+        mcts.setStop(stop);
+    }
+    // Thinking time of the next moves of a SEARCH or UCT agent, 0 for no
+    // limit
+    void setMoveTime(int moveTimeMs) {
+        spec.moveTimeMs = moveTimeMs;
+        search.setTimeBudget(moveTimeMs);
+        mcts.setTimeBudget(moveTimeMs);
+    }
+    // Searches board, with the opponent to move, one ply deeper than
+    // getMove() would: the table then holds full-depth values of the
+    // positions after each of their moves. Only SEARCH agents ponder.
+    void ponder() {
+        if (spec.strategy != SEARCH || solver.canSolve(board)) {
+            return;
+        }
+        search.setMaxDepth(spec.depth + 1);
+        search.bestMove(board);
+        search.setMaxDepth(spec.depth);
+    }
+    // Expects board.exploreMoves() to have been called
     int getMove() {
+#ifdef OTHELLO_STATS
+        using namespace std::chrono;
+        MoveReport move = {board.getEmptyCount(), board.getPlayer(),
+                          PASSING_MOVE, "", 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+        long long ttProbes = table.getProbes(), ttHits = table.getHits();
+        auto start = steady_clock::now();
+        const char *phase = ""; // every strategy sets it
+        move.move = chooseMove(phase, move.bookSeconds);
+        record(move, phase,
+               duration<double>(steady_clock::now() - start).count(),
+               ttProbes, ttHits);
+        return move.move;
+#else
+        const char *phase = ""; // every strategy sets it
+        double bookSeconds;
+        return chooseMove(phase, bookSeconds);
+#endif
+    }
+    // Sets phase to what chose the move, and bookSeconds to the time spent
+    // looking it up when built with OTHELLO_STATS
+    int chooseMove(const char *&phase, double &bookSeconds) {
+#ifndef OTHELLO_STATS
+        (void)bookSeconds;
+#endif
         int move = PASSING_MOVE;
-        board.printMoves();
-        if (AI) {
-            move = board.greedy();
+        if (verbose) {
+            board.printMoves();
+        }
+        MoveList &moves = board.getMoves();
+        bool thinks = spec.strategy == GREEDY || spec.strategy == SEARCH ||
+                      spec.strategy == UCT;
+        if (thinks && book) {
+            STATS(auto start = std::chrono::steady_clock::now());
+            move = book->lookup(board);
+            STATS(bookSeconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start).count());
+            // A hash collision could give an illegal move
+            if (moves.contains(move)) {
+                if (verbose) {
+                    cout << "I move to " << move << " from the book" << endl;
+                }
+                phase = "book";
+                return move;
+            }
+        }
+        if (spec.endgameEmpties > 0 && solver.canSolve(board)) {
+            move = solver.bestMove(board);
+            if (verbose) {
+                cout << "I move to " << move << ": ";
+                solver.printStats();
+            }
+            phase = "endgame";
+            return move;
+        }
+        switch (spec.strategy) {
+            case SEARCH:
+                move = search.bestMove(board);
+                if (verbose) {
+                    cout << "I move to " << move << ": ";
+                    search.printStats();
+                    table.printStats();
+                }
+                phase = "search";
+                return move;
+            case UCT:
+                move = mcts.bestMove(board);
+                if (verbose) {
+                    cout << "I move to " << move << ": ";
+                    mcts.printStats();
+                }
+                phase = "mcts";
+                return move;
+            case GREEDY:
+                move = board.greedy();
+                phase = "greedy";
+                break;
+            case RANDOM:
+                if (!moves.empty()) {
+                    move = moves[uniform_int_distribution<int>(
+                        0, moves.size() - 1)(rng)].to;
+                }
+                phase = "random";
+                break;
+            case HUMAN:
+                phase = "human";
+                return readHumanMove(moves);
+        }
+        if (verbose) {
             cout << "I move to " << move << endl;
-        } else {
-            move = readHumanMove(board.getMoves());
         }
         return move;
     }
-    int readHumanMove(const MovesMap &moves) {
+    // The moves of the game so far, empty without OTHELLO_STATS; a new game
+    // starts with clearStats()
+    const GameStats &getStats() const {return stats;}
+    void clearStats() {stats.clear();}
+    int readHumanMove(const MoveList &moves) {
         int move = PASSING_MOVE;
 
         do {
             cout << "Which one are you choosing? ";
             cin >> move;
-        } while (moves.find(move) == moves.end() && move != PASSING_MOVE);
+        } while (!moves.contains(move) && move != PASSING_MOVE);
         return move;
     }
 
@@ -0,0 +1,62 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Agent.hpp"
+#include "Board.hpp"
+
+#ifndef _ASYNC_AGENT_HPP
+#define _ASYNC_AGENT_HPP
+
+// An Agent thinking on a worker thread, for callers that must not wait for
+// it such as the GUI event loop. The worker plays on its own copy of the
+// position, so the caller's board stays free to draw and to play on.
+// Between its moves the agent can ponder: it searches the position the
+// opponent has to play from, which fills the transposition table it will
+// search its own reply with.
+// Only one thread may call the methods.
+class AsyncAgent
+{
+    enum Task {IDLE, THINK, PONDER, QUIT};
+
+    OthelloBoard board; // the worker's copy
+    Agent agent;
+    std::atomic<bool> stop; // aborts the running task
+    std::thread worker;
+
+    std::mutex taskMutex;
+    std::condition_variable wake;
+    Task task, running; // next and current
+    std::string position; // of task
+    unsigned generation; // of task, a cancelled task's move is dropped
+    bool forced; // forceMove() came before the worker started task
+    bool ready;
+    int result;
+
+    void run();
+    void start(Task next, const OthelloBoard &from);
+
+public:
+    AsyncAgent(const AgentSpec &spec, int edgeSize, unsigned seed=0,
+               const OpeningBook *book=nullptr,
+               const PatternEval *eval=nullptr);
+    AsyncAgent(const AsyncAgent &) = delete;
+    AsyncAgent &operator=(const AsyncAgent &) = delete;
+    ~AsyncAgent();
+
+    // Starts looking for the move of the player to move on from, instead
+    // of whatever the agent was doing
+    void think(const OthelloBoard &from);
+    // Starts searching from while the opponent thinks; nothing comes out
+    // of it but a warmer transposition table
+    void ponder(const OthelloBoard &from);
+    // true once the move think() looked for is ready, then sets move
+    bool poll(int &move);
+    // Makes the running think() settle for its best move so far
+    void forceMove();
+    // Stops thinking or pondering, no move comes out of it
+    void cancel();
+    bool isThinking();
+};
+
+#endif
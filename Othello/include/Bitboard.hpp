@@ -0,0 +1,198 @@
+#include <cstdint>
+#include <type_traits>
+
+#ifndef _BITBOARD_HPP
+#define _BITBOARD_HPP
+
+// Boards with up to 64 cells live in a single uint64_t, boards up to
+// BITBOARD_MAX_EDGE in a WideBits; bigger boards use the cell scanner.
+// The common sizes have a FixedGen, the others a runtime BitboardGen.
+#define BITBOARD_NARROW_EDGE 8
+#define BITBOARD_MAX_EDGE 16
+#define BITBOARD_WORDS 4 // 16 * 16 cells / 64 bits
+
+// Directions of the generator, also those of Move::lines
+#define N_DIRECTIONS 8
+enum Direction {EAST, WEST, SOUTH, NORTH, SOUTH_EAST, SOUTH_WEST, NORTH_EAST,
+                NORTH_WEST};
+
+typedef uint64_t Bits;
+
+// Fixed-width multi-word bit set, bit i is SquareBoard::cells[i]
+template <int W>
+struct WordBits
+{
+    uint64_t w[W];
+
+    constexpr WordBits operator&(const WordBits &o) const {
+        WordBits r = {};
+        for (int i = 0; i < W; ++i) r.w[i] = w[i] & o.w[i];
+        return r;
+    }
+    constexpr WordBits operator|(const WordBits &o) const {
+        WordBits r = {};
+        for (int i = 0; i < W; ++i) r.w[i] = w[i] | o.w[i];
+        return r;
+    }
+    constexpr WordBits operator~() const {
+        WordBits r = {};
+        for (int i = 0; i < W; ++i) r.w[i] = ~w[i];
+        return r;
+    }
+    constexpr WordBits &operator|=(const WordBits &o) {
+        for (int i = 0; i < W; ++i) w[i] |= o.w[i];
+        return *this;
+    }
+    constexpr WordBits &operator&=(const WordBits &o) {
+        for (int i = 0; i < W; ++i) w[i] &= o.w[i];
+        return *this;
+    }
+    // Shifts are only ever by less than a word (at most edgeSize + 1)
+    constexpr WordBits operator<<(int s) const {
+        WordBits r = {};
+        r.w[0] = w[0] << s;
+        for (int i = 1; i < W; ++i)
+            r.w[i] = (w[i] << s) | (w[i - 1] >> (64 - s));
+        return r;
+    }
+    constexpr WordBits operator>>(int s) const {
+        WordBits r = {};
+        for (int i = 0; i < W - 1; ++i)
+            r.w[i] = (w[i] >> s) | (w[i + 1] << (64 - s));
+        r.w[W - 1] = w[W - 1] >> s;
+        return r;
+    }
+};
+
+typedef WordBits<BITBOARD_WORDS> WideBits;
+
+// Uniform helpers so that the move generator is written once for all widths
+constexpr Bits bitAt(Bits, int pos) {return 1ULL << pos;}
+inline bool bitAny(Bits b) {return b != 0;}
+inline bool bitTest(Bits b, int pos) {return (b >> pos) & 1;}
+inline int bitCount(Bits b) {return __builtin_popcountll(b);}
+inline int bitPopLowest(Bits &b) {
+    int pos = __builtin_ctzll(b);
+    b &= b - 1;
+    return pos;
+}
+
+template <int W>
+constexpr WordBits<W> bitAt(const WordBits<W> &, int pos) {
+    WordBits<W> r = {};
+    r.w[pos >> 6] = 1ULL << (pos & 63);
+    return r;
+}
+template <int W>
+inline bool bitAny(const WordBits<W> &b) {
+    uint64_t any = 0;
+    for (int i = 0; i < W; ++i) any |= b.w[i];
+    return any != 0;
+}
+template <int W>
+inline bool bitTest(const WordBits<W> &b, int pos) {
+    return (b.w[pos >> 6] >> (pos & 63)) & 1;
+}
+template <int W>
+inline int bitCount(const WordBits<W> &b) {
+    int count = 0;
+    for (int i = 0; i < W; ++i)
+        count += __builtin_popcountll(b.w[i]);
+    return count;
+}
+template <int W>
+inline int bitPopLowest(WordBits<W> &b) {
+    for (int i = 0; i < W; ++i) {
+        if (b.w[i]) {
+            int pos = (i << 6) + __builtin_ctzll(b.w[i]);
+            b.w[i] &= b.w[i] - 1;
+            return pos;
+        }
+    }
+    return -1;
+}
+
+// The low cells of a WideBits in a narrower set
+inline void bitLow(const WideBits &b, Bits &low) {low = b.w[0];}
+template <int W>
+inline void bitLow(const WideBits &b, WordBits<W> &low) {
+    for (int i = 0; i < W; ++i) low.w[i] = b.w[i];
+}
+
+// Cells of an edgeSize board outside column skipCol (-1 for none)
+template <typename B>
+constexpr B edgeMask(int edgeSize, int skipCol) {
+    B mask = {};
+    for (int pos = 0; pos < edgeSize * edgeSize; ++pos) {
+        if (pos % edgeSize != skipCol) {
+            mask |= bitAt(mask, pos);
+        }
+    }
+    return mask;
+}
+
+// Shift-and-mask move generator for one board size.
+// B is Bits for boards up to 8x8 and WideBits up to BITBOARD_MAX_EDGE.
+template <typename B>
+class BitboardGen
+{
+    int edgeSize, nCells;
+    B full;        // all cells of the board
+    B notFirstCol; // landing here after an eastward step means a row wrap
+    B notLastCol;  // same for westward steps
+
+    B shift(const B &b, int dir) const;
+
+public:
+    BitboardGen() = delete;
+    BitboardGen(int edgeSize);
+
+    typedef B Bitset;
+
+    int getEdgeSize() const {return edgeSize;}
+
+    // Empty cells where a disc of own flips at least one disc of opp
+    B legal(const B &own, const B &opp) const;
+    // Discs of opp flipped by own playing at pos
+    B flips(const B &own, const B &opp, int pos) const;
+    // Same as the number of flips in each direction, returns their sum
+    int lines(const B &own, const B &opp, int pos,
+              uint8_t counts[N_DIRECTIONS]) const;
+};
+
+// Same generator with the board size known at compile time: direction
+// offsets and edge masks are constants and the loops over directions and
+// line lengths unroll. Instantiated for FixedGen<N> with N in 4, 6, 8, 10,
+// other sizes use BitboardGen.
+template <int N>
+class FixedGen
+{
+public:
+    typedef typename std::conditional<N * N <= 64, Bits,
+                                      WordBits<(N * N + 63) / 64>>::type Bitset;
+
+private:
+    typedef Bitset B;
+    static constexpr B full = edgeMask<B>(N, -1);
+    static constexpr B notFirstCol = edgeMask<B>(N, 0);
+    static constexpr B notLastCol = edgeMask<B>(N, N - 1);
+
+    template <int Dir>
+    static B shift(const B &b);
+    // Run of opp discs next to start in direction Dir, whether or not own
+    // closes it
+    template <int Dir>
+    static B run(const B &opp, const B &start);
+    template <int Dir>
+    static B closedRun(const B &own, const B &opp, const B &start);
+
+public:
+    static int getEdgeSize() {return N;}
+
+    static B legal(const B &own, const B &opp);
+    static B flips(const B &own, const B &opp, int pos);
+    static int lines(const B &own, const B &opp, int pos,
+                     uint8_t counts[N_DIRECTIONS]);
+};
+
+#endif
@@ -1,6 +1,8 @@
-#include <map>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include "Bitboard.hpp"
+#include "MoveList.hpp"
 
 #ifndef _BOARD_HPP
 #define _BOARD_HPP
@@ -8,10 +10,38 @@
 #define MINIMUM_OTHELLO_BOARD_SIZE 3
 #define PASSING_MOVE -1
 
-typedef std::map<int, std::vector<int>> MovesMap;
+#define ZOBRIST_TABLE_CELLS 256 // keys for bigger boards are mixed on the fly
 
 enum Cell: char {EMPTY = '.', BLACK = 'x', WHITE = 'o'};
 
+// What OthelloBoard::unmakeMove needs to take a move back
+struct UndoRecord
+{
+    int move; // PASSING_MOVE for a pass
+    int flipsBegin; // index of the first flipped cell in UndoStack::flips
+    int blackCount, whiteCount;
+    uint64_t hash;
+};
+
+// Preallocated history of OthelloBoard::makeMove. Copies keep the reserved
+// capacity, so a board copied for a search does not allocate either.
+struct UndoStack
+{
+    std::vector<UndoRecord> records;
+    std::vector<int> flips;
+
+    UndoStack(int nRecords, int nFlips) {
+        records.reserve(nRecords);
+        flips.reserve(nFlips);
+    }
+    UndoStack(const UndoStack &other)
+        : UndoStack(other.records.capacity(), other.flips.capacity()) {
+        records = other.records;
+        flips = other.flips;
+    }
+    UndoStack &operator=(const UndoStack &other) = default;
+};
+
 class SquareBoard
 {
 protected:
@@ -29,7 +59,7 @@ public:
     bool print() const;
 
     // Setters getters
-    int getEdgeSize() {return edgeSize;}
+    int getEdgeSize() const {return edgeSize;}
 
     // Move handling
     bool validPosition(int pos) {return 0 <= pos && pos < nCells;}
@@ -38,34 +68,107 @@ public:
 class OthelloBoard : public SquareBoard
 {
     int blackCount, whiteCount;
-    MovesMap moves;
+    MoveList moves;
+    int offsets[N_DIRECTIONS]; // cell index step of each Direction
+    uint64_t hash; // Zobrist hash of the discs, see getHash()
+    UndoStack undo;
+
+    // Bitboard backend mirroring cells for edgeSize <= BITBOARD_MAX_EDGE,
+    // smaller boards use the first words only. The generators serve the
+    // sizes without a FixedGen.
+    WideBits blackBits, whiteBits;
+    BitboardGen<Bits> narrowGen;
+    BitboardGen<WideBits> wideGen;
+
+    void syncCells();
+    void syncBits();
+    void setBit(int pos, char cell);
+    // Gen is a BitboardGen or a FixedGen
+    template <typename Gen>
+    void exploreBits(const Gen &gen, const WideBits &own, const WideBits &opp);
+    template <typename Gen>
+    int countBits(const Gen &gen, const WideBits &own,
+                  const WideBits &opp) const;
+    template <typename Gen>
+    void collectBits(const Gen &gen, const WideBits &own, const WideBits &opp,
+                     int to);
+    void collectFlips(int to);
+    int scanLines(int to, uint8_t counts[N_DIRECTIONS], char side) const;
+    void flipDisc(int pos, char opponent);
+    int countMovesOf(char side) const;
+
+    // Boards beyond the bitboard backend keep the cells each side may play
+    // to, one bit per cell and side. A disc that changes only changes the
+    // first empty cell of each of its lines, so a move updates those
+    // instead of rescanning the board.
+    std::vector<uint64_t> legalCells[2]; // BLACK, WHITE
+    int mobility[2];
+    std::vector<int> refreshed; // stamp of the update that last saw a cell
+    int updates;
+
+    bool scanned() const {return edgeSize > BITBOARD_MAX_EDGE;}
+    bool isLegal(int to, char side) const;
+    void setLegal(int side, int pos, bool legal);
+    void syncLegal();
+    // After the cells at to and flips changed
+    void updateLegal(int to, const int *flips, int nFlips);
 public:
     // Setup
     OthelloBoard(int edgeSize, char player=BLACK);
+    // MINIMUM_ to MAXIMUM_OTHELLO_BOARD_SIZE. The maximum bounds the move
+    // list, which every board holds, and the tables of the evaluation.
+    static bool supports(int edgeSize) {
+        return edgeSize >= MINIMUM_OTHELLO_BOARD_SIZE &&
+               edgeSize <= MAXIMUM_OTHELLO_BOARD_SIZE;
+    }
 
     void printMoves() const;
 
+    // Positions are written row by row with '/' between rows and the
+    // player to move after a space, e.g. "x.o/.xo/... o" for 3x3
+    static int edgeSizeOf(const std::string &position); // 0 if malformed
+    bool setPosition(const std::string &position);
+    std::string getPosition() const;
+
     // Setters getters
     void setPlayer(char player) {this->player = player;}
-    char getPlayer() {return player;}
-    MovesMap &getMoves() {return moves;}
+    char getPlayer() const {return player;}
+    MoveList &getMoves() {return moves;}
     std::vector<char> &getCells() {return cells;}
+    const std::vector<char> &getCells() const {return cells;}
     std::vector<char> copyCells() {return std::vector<char> (cells);}
+    // Position identity including the player to move
+    uint64_t getHash() const {return player == WHITE ? ~hash : hash;}
 
     // Move handling
-    bool isGameOver();
+    // Neither side can move; cheap, it does not touch getMoves()
+    bool isGameOver() const;
     void changePlayer() {setPlayer(player == BLACK ? WHITE : BLACK);}
     int score() const {return blackCount - whiteCount;}
-    void exploreDirection(int cellPos, int inc);
+    int getEmptyCount() const {return nCells - blackCount - whiteCount;}
+    // Discs the player to move would flip playing to, 0 if to is not
+    // legal; to must be empty
+    int countFlips(int to) const;
+    // Number of legal moves of the player to move, cheaper than
+    // exploreMoves()
+    int countMoves() const;
     void exploreMoves();
     void move(int to);
+    // Plays to (or passes) without exploreMoves(), returns the number of
+    // flipped discs; unmakeMove() restores the position before it
+    int makeMove(int to);
+    void unmakeMove();
+    int getPly() const {return undo.records.size();}
 
     // Algorithms
-    int random();
+    // Move number r modulo the number of moves, the first one by default
+    int random(unsigned r=0) const;
     int greedy();
-    int minimax();
+    int minimax(int depth); // alpha-beta search, see Search
 };
 
+// Zobrist key of a disc of colour cell (BLACK or WHITE) at pos
+uint64_t zobristKey(int pos, char cell);
+
 void printVector(const std::vector<int> &v);
-void printMovesMap(const MovesMap &moves);
 #endif
@@ -0,0 +1,79 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "Board.hpp"
+
+#ifndef _ENDGAME_HPP
+#define _ENDGAME_HPP
+
+#define ENDGAME_DEFAULT_EMPTIES 14 // agents solve from this many empty cells
+#define ENDGAME_STATS_EMPTIES 64 // statistics are kept up to this empty count
+#define ENDGAME_SHALLOW_EMPTIES 4 // below, moves come from the empty cells
+#define ENDGAME_FASTEST_FIRST_EMPTIES 7 // from here on, fastest-first order
+#define ENDGAME_INF (MAXIMUM_OTHELLO_BOARD_SIZE * MAXIMUM_OTHELLO_BOARD_SIZE + 1)
+
+// Solves of the positions with one empty count
+struct EndgameStats
+{
+    long long solves, nodes;
+    double seconds;
+};
+
+// Exact solver for the end of the game: a full-width alpha-beta search to
+// the last move, valued by the final disc differential.
+// Moves into regions (board quadrants) with an odd number of empty cells
+// go first, far from the end they are then sorted by the opponent's
+// mobility (fastest first). The last empty cells are played straight from
+// the list of empties without generating moves, the very last one without
+// even playing it.
+class EndgameSolver
+{
+    int maxEmpties;
+    std::vector<int> empties; // empty cells of the root
+    std::vector<int> quadrants; // parity region of each cell
+    // The moves being searched by empty count; a pass keeps the count but
+    // has no moves of its own
+    std::vector<MoveList> plyMoves;
+
+    // Statistics of the last call, and of all calls by empty count
+    long long nodes;
+    int bestScore;
+    double elapsed;
+    std::vector<EndgameStats> stats;
+
+    void setRoot(OthelloBoard &board);
+    int parity(const std::vector<char> &cells) const;
+    void orderMoves(OthelloBoard &board, MoveList &moves, int nEmpties);
+    int finalScore(const OthelloBoard &board) const;
+    int solveLast(OthelloBoard &board);
+    int solveShallow(OthelloBoard &board, int alpha, int beta, bool passed);
+    int solve(OthelloBoard &board, int alpha, int beta, bool passed);
+    void record(const OthelloBoard &board,
+                std::chrono::steady_clock::time_point startTime);
+
+public:
+    EndgameSolver(int maxEmpties=ENDGAME_DEFAULT_EMPTIES);
+    ~EndgameSolver() {}
+
+    int getMaxEmpties() const {return maxEmpties;}
+    bool canSolve(const OthelloBoard &board) const {
+        return board.getEmptyCount() <= maxEmpties;
+    }
+
+    // Best move for the player to move on board, PASSING_MOVE if none
+    int bestMove(const OthelloBoard &board);
+    // Final score() of board if both sides play perfectly
+    int solve(const OthelloBoard &board);
+
+    long long getNodes() const {return nodes;}
+    // Final score() of the last solve
+    int getScore() const {return bestScore;}
+    double getElapsed() const {return elapsed;}
+    double getNodesPerSecond() const;
+    const std::vector<EndgameStats> &getStats() const {return stats;}
+    void printStats(std::ostream &out=std::cout) const;
+    // Time and speed of all solves so far by empty count
+    void printStatsByEmpties(std::ostream &out=std::cout) const;
+};
+
+#endif
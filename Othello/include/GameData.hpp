@@ -0,0 +1,150 @@
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Board.hpp"
+
+#ifndef _GAME_DATA_HPP
+#define _GAME_DATA_HPP
+
+#define GAMES_MAGIC "OTHGAME"
+#define GAMES_VERSION 1
+#define GAMES_CHUNK_MAGIC 0x4b4e4843 // "CHNK"
+#define GAMES_CHUNK_BYTES (1 << 20) // of records before compression
+#define GAMES_COMPRESSED 1 // ChunkHeader flag, the payload is zlib data
+
+// File layout, in host byte order: a GamesHeader, then chunks appended one
+// after the other, each a ChunkHeader followed by storedSize bytes of
+// payload. The payload, once uncompressed, is the records of games
+// complete games. A file cut short by a crash loses its last chunk only,
+// GameWriter::open() drops it before appending.
+struct GamesHeader
+{
+    char magic[8]; // GAMES_MAGIC
+    uint32_t version;
+    uint32_t reserved;
+};
+
+struct ChunkHeader
+{
+    uint32_t magic; // GAMES_CHUNK_MAGIC
+    uint32_t flags;
+    uint32_t rawSize; // of the records
+    uint32_t storedSize; // of the payload
+    uint32_t games;
+    uint32_t checksum; // CRC-32 of the payload
+};
+
+// One self-play game: each position reached, the player to move and the
+// move played from it, and the final score
+struct GameRecord
+{
+    int edgeSize = 0;
+    int score = 0; // board.score() at the end of the game
+    std::vector<char> players;
+    std::vector<int16_t> moves;
+    std::vector<uint8_t> cells; // 4 cells per byte, position after position
+
+    void clear(int edgeSize);
+    // Records board before move is played on it
+    void add(const OthelloBoard &board, int move);
+
+    int plies() const {return moves.size();}
+    int positionBytes() const {return (edgeSize * edgeSize + 3) / 4;}
+    // Cells of the position at ply, as in OthelloBoard::getCells()
+    void position(int ply, std::vector<char> &cells) const;
+
+    // Record bytes: edgeSize, score, plies, then the players, moves and
+    // cells arrays
+    void append(std::vector<char> &out) const;
+    // false if data does not hold a whole record
+    bool parse(const char *&data, const char *end);
+
+    bool operator==(const GameRecord &other) const;
+};
+
+// Appends games to a file. Game threads only copy their record into the
+// chunk being filled; a background thread compresses, checksums and writes
+// full chunks, so they never wait for the disk.
+class GameWriter
+{
+    struct Chunk
+    {
+        std::vector<char> records;
+        int games;
+    };
+
+    std::ofstream out;
+    std::string path;
+    bool compress;
+    size_t chunkBytes;
+
+    std::mutex queueMutex;
+    std::condition_variable ready;
+    Chunk filling;
+    std::deque<Chunk> queue; // full chunks for the background thread
+    bool closing;
+    std::thread background;
+
+    // Written by the background thread, read after close()
+    bool failed;
+    long long games, chunks, rawBytes, storedBytes;
+
+    void run();
+    void writeChunk(Chunk &chunk, std::vector<char> &buffer);
+
+public:
+    GameWriter();
+    GameWriter(const GameWriter &) = delete;
+    GameWriter &operator=(const GameWriter &) = delete;
+    ~GameWriter() {close();}
+
+    // Built with zlib
+    static bool canCompress();
+
+    // Appends to path, creating it if needed, after its last chunk that
+    // reads whole; anything after that is dropped with a message on cerr.
+    // false with a message on cerr if path cannot be written or is not a
+    // game file.
+    bool open(const std::string &path, bool compress=false,
+              size_t chunkBytes=GAMES_CHUNK_BYTES);
+    // Thread-safe
+    void write(const GameRecord &record);
+    // Writes what is left and waits for the background thread, false if
+    // anything could not be written
+    bool close();
+
+    long long getGames() const {return games;}
+    long long getChunks() const {return chunks;}
+    long long getRawBytes() const {return rawBytes;}
+    long long getStoredBytes() const {return storedBytes;}
+};
+
+// Reads the games of a file chunk by chunk, checking every checksum
+class GameReader
+{
+    std::ifstream in;
+    std::string path;
+    std::vector<char> records; // of the current chunk
+    size_t offset;
+    int remaining; // games left in records
+    bool corrupt;
+
+    bool readChunk();
+
+public:
+    GameReader() : offset(0), remaining(0), corrupt(false) {}
+
+    // false with a message on cerr if path is not a game file
+    bool open(const std::string &path);
+    // false at the end of the file or at the first damaged chunk, with a
+    // message on cerr then
+    bool next(GameRecord &record);
+    bool isCorrupt() const {return corrupt;}
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include <string>
 #include <SFML/Graphics.hpp>
 #include <SFML/Window/Keyboard.hpp>
+#include "AsyncAgent.hpp"
 #include "Board.hpp"
 
 #ifndef _GUI_HPP
@@ -8,6 +9,7 @@
 
 #define WINDOW_NAME "Othello player"
 #define WINDOW_SCALE 0.5
+#define WINDOW_POLL_MS 15 // while the AI thinks, between two polls
 
 #define DIVIDER_THICKNESS 10
 #define DIVIDER_POSITION 0.6
@@ -16,38 +18,62 @@
 #define BOARD_THICKNESS 4
 
 #define DISC_RADIUS_RATIO 0.4
+#define DISC_SEGMENTS 32 // triangles of a disc
+#define DISC_VERTICES (3 * DISC_SEGMENTS)
 
 typedef struct Base_
 {
-    sf::RectangleShape background;
-    std::vector<sf::RectangleShape> grid;
+    sf::VertexArray vertices; // outline, background and grid lines
     int offset, step;
 } Base;
 
+// The board is two vertex arrays, drawn with one call each: the base never
+// changes, the discs of all cells are triangle fans whose colour is only
+// rewritten for the cells that changed.
 class BoardGui {
     int edgeSize, nCells;
     Base base;
-    std::vector<sf::CircleShape> discs;
+    sf::VertexArray discs; // DISC_VERTICES a cell
+    std::vector<char> shown; // cell each disc shows
+
+    void paint(int cell, char disc);
 
 public:
     BoardGui() = delete;
     BoardGui(int edgeSize);
     ~BoardGui() {}
-    void update(std::vector<char> &cells);
+    // true if any disc changed
+    bool update(const std::vector<char> &cells);
     void place(int height);
-    void click(int x, int y, OthelloBoard &board);
+    // true if the click played a move on board
+    bool click(int x, int y, OthelloBoard &board);
     void draw(sf::RenderWindow &window);
 };
 
+// Mouse clicks play the human's moves, Space passes. The AI, if any,
+// thinks on its own thread and ponders while the human thinks, so the
+// window keeps drawing; Enter makes it move at once, Escape cancels its
+// search and leaves its move to the mouse.
 class Game {
     OthelloBoard &board;
+    AsyncAgent *ai; // nullptr for two humans
+    char aiPlayer;
+    bool aiCancelled; // the human plays the AI's current move
+    bool redraw; // the window does not show the board as it is
     sf::RenderWindow window;
     sf::RectangleShape divider;
     BoardGui boardGui;
 
+    bool humanToMove() const;
+    bool aiThinking() const {return ai && !humanToMove();}
+    void startTurn();
+    void endTurn();
+    void handle(const sf::Event &event);
+
 public:
     Game() = delete;
-    Game(OthelloBoard &board, const std::string windowName=WINDOW_NAME);
+    Game(OthelloBoard &board, AsyncAgent *ai=nullptr, char aiPlayer=BLACK,
+         const std::string windowName=WINDOW_NAME);
     ~Game() {};
     void play();
     void closeWindow();
@@ -0,0 +1,101 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Board.hpp"
+
+#ifndef _MCTS_HPP
+#define _MCTS_HPP
+
+#define MCTS_DEFAULT_PLAYOUTS 10000
+#define MCTS_DEFAULT_NODES (1 << 20) // 16 MB of tree
+#define MCTS_EXPLORATION 1.4 // UCT constant
+#define MCTS_VIRTUAL_LOSS 1 // visits a thread adds on its way down
+
+// Tree node, children of a node are consecutive in the arena.
+// Scores are counted in half points (2 per win, 1 per draw) for the player
+// who played move, visits include the virtual losses of the threads still
+// below the node.
+struct MCTSNode
+{
+    std::atomic<int32_t> visits, score;
+    std::atomic<int32_t> firstChild; // MCTS_LEAF until expanded
+    int16_t move, nChildren; // nChildren is set before firstChild
+};
+
+#define MCTS_LEAF -1
+#define MCTS_EXPANDING -2 // a thread is creating the children
+#define MCTS_FULL -3 // no room for the children, played out from for good
+
+// Fixed-size pool the tree is carved from; allocating reserves the nodes
+// with a compare-and-swap and the whole tree is freed at once by reset()
+class NodeArena
+{
+    std::unique_ptr<MCTSNode[]> nodes;
+    int capacity;
+    std::atomic<int> used;
+
+public:
+    NodeArena(int capacity);
+
+    void reset() {used = 0;}
+    // Index of count consecutive nodes, -1 if the arena has not that many
+    // left; a failed allocation reserves nothing
+    int allocate(int count);
+    MCTSNode &operator[](int i) {return nodes[i];}
+    int getUsed() const {return used;}
+    int getCapacity() const {return capacity;}
+};
+
+// Monte Carlo tree search with UCT selection and random playouts.
+// With more than one thread the search is tree-parallel: all threads walk
+// and grow the same tree, and the virtual losses they add on their way
+// down steer the others to different branches.
+class MCTS
+{
+    int maxPlayouts;
+    int timeBudgetMs; // 0 for no limit
+    int threads;
+    unsigned seed;
+    NodeArena arena;
+
+    std::atomic<int> playoutsStarted;
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<bool> *stop; // optional, see setStop()
+
+    // Statistics of the last bestMove() call
+    long long playouts;
+    double elapsed; // seconds
+    double bestWinRate;
+
+    void expand(OthelloBoard &board, int node);
+    int select(int node);
+    int rollout(OthelloBoard &board, std::minstd_rand &rng);
+    void runWorker(const OthelloBoard &board, unsigned workerSeed);
+
+public:
+    MCTS(int maxPlayouts=MCTS_DEFAULT_PLAYOUTS, int timeBudgetMs=0,
+         int threads=1, unsigned seed=0, int nodes=MCTS_DEFAULT_NODES);
+    ~MCTS() {}
+
+    // Most visited move for the player to move on board, PASSING_MOVE if
+    // none
+    int bestMove(const OthelloBoard &board);
+    // Setting *stop makes bestMove() return its best move so far, as when
+    // the time is up; nullptr for none
+    void setStop(std::atomic<bool> *stop) {this->stop = stop;}
+    // 0 for no limit, then the playouts bound the search
+    void setTimeBudget(int timeBudgetMs);
+
+    int getThreads() const {return threads;}
+    long long getPlayouts() const {return playouts;}
+    double getElapsed() const {return elapsed;}
+    double getPlayoutsPerSecond() const;
+    int getTreeSize() const {return arena.getUsed();}
+    void printStats(std::ostream &out=std::cout) const;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cstdint>
+#include "Bitboard.hpp"
+
+#ifndef _MOVE_LIST_HPP
+#define _MOVE_LIST_HPP
+
+#define MAXIMUM_OTHELLO_BOARD_SIZE 32
+// A board never has more legal moves than empty cells
+#define MOVE_LIST_CAPACITY (MAXIMUM_OTHELLO_BOARD_SIZE * MAXIMUM_OTHELLO_BOARD_SIZE)
+
+// A legal move: its cell and how many discs it flips in each direction
+struct Move
+{
+    int16_t to;
+    int16_t score; // ordering key, the number of flips unless reordered
+    uint8_t lines[N_DIRECTIONS];
+
+    int flips() const {
+        int total = 0;
+        for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+            total += lines[dir];
+        }
+        return total;
+    }
+};
+
+// Fixed-capacity list of the legal moves of one position. It lives inside
+// the board or on the stack, so generating moves never allocates. Copies
+// only touch the used entries.
+class MoveList
+{
+    int count;
+    Move moves[MOVE_LIST_CAPACITY];
+
+public:
+    MoveList() : count(0) {}
+    MoveList(const MoveList &other) : count(other.count) {
+        std::copy(other.begin(), other.end(), moves);
+    }
+    MoveList &operator=(const MoveList &other) {
+        count = other.count;
+        std::copy(other.begin(), other.end(), moves);
+        return *this;
+    }
+
+    void clear() {count = 0;}
+    // New entry for to with no flips yet
+    Move &add(int to) {
+        Move &move = moves[count++];
+        move = Move{(int16_t)to, 0, {}};
+        return move;
+    }
+
+    bool empty() const {return count == 0;}
+    int size() const {return count;}
+    Move &operator[](int i) {return moves[i];}
+    const Move &operator[](int i) const {return moves[i];}
+    Move *begin() {return moves;}
+    Move *end() {return moves + count;}
+    const Move *begin() const {return moves;}
+    const Move *end() const {return moves + count;}
+
+    // nullptr if to is not in the list
+    const Move *find(int to) const {
+        for (const Move &move: *this) {
+            if (move.to == to) {
+                return &move;
+            }
+        }
+        return nullptr;
+    }
+    bool contains(int to) const {return find(to) != nullptr;}
+
+    // Highest score first, ties keep their order. Insertion sort, the
+    // lists are short and std::stable_sort may allocate.
+    void sort() {
+        for (int i = 1; i < count; ++i) {
+            Move move = moves[i];
+            int j = i;
+            for (; j > 0 && moves[j - 1].score < move.score; --j) {
+                moves[j] = moves[j - 1];
+            }
+            moves[j] = move;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include <cstdint>
+#include <vector>
+#include "MoveList.hpp"
+
+#ifndef _MOVE_ORDERING_HPP
+#define _MOVE_ORDERING_HPP
+
+// Heuristics, combined as a mask
+#define ORDER_NONE 0
+#define ORDER_STATIC 1 // corners first, X-squares last
+#define ORDER_TT 2 // the table's best move first
+#define ORDER_KILLERS 4 // moves that cut off at the same ply
+#define ORDER_HISTORY 8 // moves that cut off anywhere, by depth
+#define ORDER_ALL 15
+// On the boards the ordering tool measures, history adds nothing to the
+// killers and the table's move, so it is off unless asked for
+#define ORDER_DEFAULT (ORDER_STATIC | ORDER_TT | ORDER_KILLERS)
+
+#define ORDER_MAX_PLY 128 // deeper plies get no killers
+#define ORDER_KILLERS_PER_PLY 2
+// Ordering keys of Move::score, highest first
+#define ORDER_TT_KEY 32000
+#define ORDER_KILLER_BONUS 1500 // minus the killer's slot
+#define ORDER_CORNER 2000
+#define ORDER_EDGE 500
+#define ORDER_C_SQUARE -1000 // next to a corner on the edge
+#define ORDER_X_SQUARE -2000 // diagonally next to a corner
+// History counts depth * depth a cutoff, the table is halved when an entry
+// passes the maximum. The key gets at most 1024 of it, a square class.
+#define ORDER_HISTORY_MAX (1 << 16)
+#define ORDER_HISTORY_SHIFT 6
+
+// Sorts the moves of a search node. Moves carry their flip count as a key
+// already, the heuristics add to it: the static value of the square, a
+// bonus for the killers of the ply and how often the move cut off before;
+// the table's move goes first. One ordering per search thread, so none of
+// it is shared.
+class MoveOrdering
+{
+    unsigned heuristics;
+    int nCells;
+    std::vector<int16_t> squares; // static value of each cell
+    int16_t killers[ORDER_MAX_PLY][ORDER_KILLERS_PER_PLY];
+    std::vector<int> history; // BLACK cells, then WHITE cells
+
+    void resize(int edgeSize);
+
+public:
+    MoveOrdering(unsigned heuristics=ORDER_DEFAULT);
+    ~MoveOrdering() {}
+
+    unsigned getHeuristics() const {return heuristics;}
+    void setHeuristics(unsigned heuristics) {this->heuristics = heuristics;}
+    // Before searching a new position on an edgeSize board: forgets the
+    // killers and ages the history
+    void prepare(int edgeSize);
+    void order(MoveList &moves, int ttMove, int ply, char player);
+    // to cut off a node searched depth plies deep
+    void cutoff(int to, int ply, int depth, char player);
+};
+
+#endif
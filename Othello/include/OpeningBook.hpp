@@ -0,0 +1,70 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Board.hpp"
+
+#ifndef _OPENING_BOOK_HPP
+#define _OPENING_BOOK_HPP
+
+#define BOOK_DEFAULT_PATH "book.bin"
+#define BOOK_MAGIC "OTHBOOK"
+#define BOOK_VERSION 1
+
+// File layout, in host byte order: a BookHeader followed by count
+// BookEntry sorted by hash
+struct BookHeader
+{
+    char magic[8]; // BOOK_MAGIC
+    uint32_t version;
+    uint32_t edgeSize;
+    uint64_t count;
+};
+
+// Best known move of one position, hash is OthelloBoard::getHash()
+struct BookEntry
+{
+    uint64_t hash;
+    int16_t move;
+    int16_t score; // average final disc differential for the player to move
+    uint32_t games; // self-play games that played move here
+};
+
+// Read-only opening book memory-mapped from a file. Loading only maps the
+// file, lookups binary search the mapping in place, so neither copies the
+// entries and many threads may share one book.
+class OpeningBook
+{
+    size_t mappedSize;
+    void *mapping;
+    int edgeSize;
+    const BookEntry *entries;
+    size_t count;
+
+public:
+    OpeningBook();
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+    ~OpeningBook();
+
+    // false with a message on cerr if path is not a valid book
+    bool load(const std::string &path);
+    // Maps $OTHELLO_BOOK, or BOOK_DEFAULT_PATH if it exists; false if
+    // neither was loaded
+    bool loadDefault();
+    void unload();
+    bool loaded() const {return mapping != nullptr;}
+
+    int getEdgeSize() const {return edgeSize;}
+    size_t size() const {return count;}
+    // nullptr if the position is not in the book
+    const BookEntry *find(uint64_t hash) const;
+    // Book move of board, PASSING_MOVE if none
+    int lookup(const OthelloBoard &board) const;
+
+    // Sorts entries and writes them as a book for edgeSize boards
+    static bool write(const std::string &path, int edgeSize,
+                      std::vector<BookEntry> entries);
+};
+
+#endif
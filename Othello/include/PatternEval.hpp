@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Board.hpp"
+#include "MoveList.hpp"
+
+#ifndef _PATTERN_EVAL_HPP
+#define _PATTERN_EVAL_HPP
+
+#define PATTERN_DEFAULT_PATH "weights.txt"
+// The 4 cells from each end of an edge or diagonal and the 3x3 corners only
+// lie apart from 8x8 on, smaller boards overlap them
+#define PATTERN_MIN_EDGE 8
+#define PATTERN_MAX_CELLS 9
+#define PATTERN_LANES 10 // pattern instances: 4 corners, 4 edges, 2 diagonals
+#define PATTERN_MOBILITY_MAX 64 // more moves share the last weight
+
+// Pattern shapes, each one is looked up in its own weight table
+enum PatternKind {CORNER, EDGE, DIAGONAL, N_PATTERN_KINDS};
+
+// Cells of every pattern instance on one board size, lane by lane. Patterns
+// of 8 cells have their 9th at cell nCells, which is always empty.
+struct PatternLanes
+{
+    int32_t cells[PATTERN_MAX_CELLS][PATTERN_LANES];
+};
+
+// Table-driven evaluation. A pattern is an ordered set of cells, its
+// configuration (each cell empty, own or opponent's) indexes a weight
+// table: the 3x3 corners, the 4 cells next to both ends of each edge and
+// of each diagonal. A mobility table adds the number of legal moves.
+// The 10 instances are laid out as lanes so that the indices and weights
+// of 8 of them are gathered with AVX2 when the CPU has it, lane by lane
+// otherwise.
+// Evaluating does not modify anything, threads may share one PatternEval.
+class PatternEval
+{
+    std::vector<int32_t> weights[N_PATTERN_KINDS];
+    std::vector<int32_t> mobility;
+
+    std::vector<PatternLanes> lanes; // by edge size
+    int32_t offsets[PATTERN_LANES]; // of each lane in table
+    std::vector<int32_t> table; // all kinds one after the other
+    bool avx2;
+
+    void buildLanes();
+    void buildTable();
+    int sumLane(const PatternLanes &lanes, const int32_t *states,
+                int lane) const;
+    int sumScalar(const PatternLanes &lanes, const int32_t *states) const;
+    int sumAvx2(const PatternLanes &lanes, const int32_t *states) const;
+
+public:
+    PatternEval();
+    ~PatternEval() {}
+
+    static int size(PatternKind kind); // 3 ^ cells of the kind
+    static const char *name(PatternKind kind);
+
+    // Hand-made weights, used until load() succeeds
+    void setDefaults();
+    // Text file of "NAME COUNT" lines, each followed by COUNT weights, for
+    // some of corner, edge, diagonal and mobility; the others keep their
+    // weights. false with a message on cerr if path is not a valid weight
+    // file, nothing changes then.
+    bool load(const std::string &path);
+    // Reads $OTHELLO_WEIGHTS, or PATTERN_DEFAULT_PATH if it exists; false if
+    // neither was read, the weights stay as they were then
+    bool loadDefault();
+    bool save(const std::string &path) const;
+
+    static bool supports(int edgeSize) {return edgeSize >= PATTERN_MIN_EDGE;}
+
+    bool usesAvx2() const {return avx2;}
+    // Only turns AVX2 on if the CPU has it
+    void setAvx2(bool on);
+
+    // From the point of view of the player to move, on a board it
+    // supports(), expects board.exploreMoves() to have been called
+    int evaluate(OthelloBoard &board) const;
+};
+
+#endif
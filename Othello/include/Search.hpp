@@ -0,0 +1,97 @@
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <vector>
+#include "Board.hpp"
+#include "MoveOrdering.hpp"
+#include "PatternEval.hpp"
+#include "Stats.hpp"
+#include "TranspositionTable.hpp"
+
+#ifndef _SEARCH_HPP
+#define _SEARCH_HPP
+
+#define SEARCH_DEFAULT_DEPTH 6
+#define SEARCH_CHECK_INTERVAL 1024 // nodes between two clock reads
+#define SEARCH_WIN 1000000 // added to the disc differential of a won game
+#define SEARCH_INF (SEARCH_WIN * 2)
+
+// Negamax with alpha-beta pruning and iterative deepening.
+// The live board is never touched, the search plays and takes back moves
+// on one copy of it. Moves are tried in MoveOrdering's order.
+// With more than one thread and a table the search is Lazy SMP: helper
+// threads run the same iterative deepening with staggered depths and root
+// orders, and share what they find only through the table.
+class Search
+{
+    int maxDepth;
+    int timeBudgetMs; // 0 for no limit
+    TranspositionTable *table; // optional, may be shared between searches
+    const PatternEval *eval; // optional, discs, corners and mobility if not
+    int threads;
+    int threadId; // 0 for the main thread, slot of the table counters
+    std::atomic<bool> *stop; // set by the main thread to stop a helper
+    std::chrono::steady_clock::time_point startTime, deadline;
+    bool aborted;
+    MoveOrdering ordering;
+    int rootPly; // getPly() of the root, plies are counted from it
+    // The moves of each ply being searched. A list is too big for the
+    // stack of every ply, and a deque grows without moving them.
+    std::deque<MoveList> plyMoves;
+
+    // Statistics of the last bestMove() call
+    long long nodes;
+    long long cutoffs, firstCutoffs; // beta cutoffs, by the first move
+    SearchCounters counters; // of this thread, then of all
+    int completedDepth, bestScore;
+    double elapsed; // seconds
+
+    bool outOfTime();
+    int evaluate(OthelloBoard &board) const;
+    int negamax(OthelloBoard &board, int depth, int alpha, int beta,
+                bool passed);
+    int searchMove(OthelloBoard &board, int to, int depth, int alpha,
+                   int beta);
+    int searchRoot(OthelloBoard &board, int depth,
+                   std::vector<int> &rootMoves);
+    void iterate(OthelloBoard &root, std::vector<int> &rootMoves,
+                 int firstDepth);
+    void prepare(const OthelloBoard &root);
+    void runHelper(const OthelloBoard &board, const std::vector<int> &moves);
+
+public:
+    Search(int maxDepth=SEARCH_DEFAULT_DEPTH, int timeBudgetMs=0,
+           TranspositionTable *table=nullptr, int threads=1,
+           const PatternEval *eval=nullptr);
+    ~Search() {}
+
+    // Best move for the player to move on board, PASSING_MOVE if none
+    int bestMove(const OthelloBoard &board);
+    // Setting *stop makes bestMove() return its best move so far, as when
+    // the time is up; nullptr for none
+    void setStop(std::atomic<bool> *stop) {this->stop = stop;}
+    int getMaxDepth() const {return maxDepth;}
+    void setMaxDepth(int maxDepth) {this->maxDepth = maxDepth;}
+    // 0 for no limit
+    void setTimeBudget(int timeBudgetMs) {this->timeBudgetMs = timeBudgetMs;}
+    // ORDER_ flags
+    void setOrdering(unsigned heuristics) {ordering.setHeuristics(heuristics);}
+
+    int getThreads() const {return threads;}
+    // Nodes of all threads
+    long long getNodes() const {return nodes;}
+    long long getCutoffs() const {return cutoffs;}
+    // All zero without OTHELLO_STATS
+    const SearchCounters &getCounters() const {return counters;}
+    // Share of the cutoffs the first move tried made, the closer to 1 the
+    // better the ordering
+    double getFirstCutoffRate() const;
+    int getCompletedDepth() const {return completedDepth;}
+    int getBestScore() const {return bestScore;}
+    double getElapsed() const {return elapsed;}
+    double getNodesPerSecond() const;
+    void printStats(std::ostream &out=std::cout) const;
+};
+
+#endif
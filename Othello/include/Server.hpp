@@ -0,0 +1,123 @@
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Agent.hpp"
+#include "Board.hpp"
+
+#ifndef _SERVER_HPP
+#define _SERVER_HPP
+
+#define SERVER_DEFAULT_SOCKET "/tmp/othello.sock"
+#define SERVER_MIN_MOVE_MS 5 // a game out of time still searches that long
+#define SERVER_MAX_ENGINES 4 // agents a pool thread keeps between searches
+#define SERVER_READ_BYTES 4096
+
+// Where the replies to a client go; pool threads answer through it too
+struct Client
+{
+    int out;
+    std::mutex outMutex;
+    bool gone; // out may be closed, replies are dropped
+    int searches; // of its games, queued or running, guarded by outMutex
+    std::condition_variable answered;
+
+    Client(int out) : out(out), gone(false), searches(0) {}
+    void reply(const std::string &line);
+    void searchQueued();
+    // After the reply to the search, if there is one
+    void searchDone();
+    // Until every search of the client's games is done
+    void waitSearches();
+};
+
+// One game. Its board always has its moves explored.
+struct Session
+{
+    std::string id;
+    std::string agentName;
+    AgentSpec spec;
+    OthelloBoard board;
+    int budgetMs; // thinking time of the whole game, 0 for the agent's own
+    long long usedMs;
+    bool busy; // a move is queued or searched
+    bool closed; // a search still running drops its move
+    std::shared_ptr<Client> client;
+
+    Session(const std::string &id, const std::string &agentName,
+            const AgentSpec &spec, int edgeSize, int budgetMs,
+            const std::shared_ptr<Client> &client);
+    // Time the next move may take out of the rest of the game's budget
+    int moveTimeMs() const;
+};
+
+// Many games in one process. Clients send one command a line and get one
+// reply line for each:
+//   new ID AGENT [EDGE_SIZE] [TIME_MS]  ok ID         starts a game
+//   play ID CELL                        ok ID         the opponent's move,
+//                                                     -1 to pass
+//   go ID                               move ID CELL  the agent's move,
+//                                                     later
+//   show ID                             board ID POSITION
+//   close ID                            ok ID
+//   stats                               stats SESSIONS QUEUED SEARCHES
+//   quit
+// play and go answer "over ID SCORE" instead once the game is over, and
+// every command "error ID REASON" when it cannot be done.
+// The searches of all the clients' games share one pool of threads, in the
+// order they were asked for. A pool thread keeps the agents of the last
+// SERVER_MAX_ENGINES agent names and board sizes it searched for. Search
+// agents hold a TT_DEFAULT_MB table and mcts ones a tree of
+// MCTS_DEFAULT_NODES nodes, 16 MB either way, so the agents take at most
+// 64 MB a thread, whatever the number of games.
+class Server
+{
+    int edgeSize; // of new games by default
+    const OpeningBook *book; // shared by all the agents, optional
+    const PatternEval *eval;
+
+    std::mutex queueMutex;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<Session>> queue;
+    bool quitting;
+    std::vector<std::thread> pool;
+
+    std::atomic<int> nSessions;
+    std::atomic<long long> searches;
+
+    // Guards the Session fields but id, agentName and spec, of all the
+    // sessions; held for a few board operations at most
+    std::mutex sessionMutex;
+
+    void runWorker(unsigned id);
+    std::string handle(const std::string &line, const std::shared_ptr<Client>
+                       &client, std::map<std::string,
+                       std::shared_ptr<Session>> &sessions);
+
+public:
+    Server() = delete;
+    Server(int edgeSize, int threads, const OpeningBook *book=nullptr,
+           const PatternEval *eval=nullptr);
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+    // Finishes the queued and running searches, and answers them
+    ~Server();
+
+    // Answers the commands read from in on out until quit or the end of in.
+    // At the end of in, the searches of the client's games are answered
+    // first; quit drops them. The client's games end with it.
+    void serve(int in, int out);
+    // Serves each client connecting to the Unix socket at path on its own
+    // thread; returns only if the socket fails
+    bool listen(const std::string &path);
+
+    int getSessions() const {return nSessions;}
+    long long getSearches() const {return searches;}
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef _STATS_HPP
+#define _STATS_HPP
+
+// Engine counters cost an increment each where they are counted. Building
+// without OTHELLO_STATS (cmake -DOTHELLO_STATS=OFF) removes them and the
+// per-move records; nodes, which the search needs for its clock, stay.
+#ifdef OTHELLO_STATS
+#define STATS(...) __VA_ARGS__
+#define STATS_ENABLED true
+#else
+#define STATS(...)
+#define STATS_ENABLED false
+#endif
+
+// Counters of one search thread, padded so that threads do not share a
+// cache line
+struct alignas(64) SearchCounters
+{
+    long long expanded; // nodes whose moves were generated and searched
+    long long movesGenerated; // by those nodes
+    long long evaluations; // static evaluations of the leaves
+};
+
+// What the engine did for one move of an agent
+struct MoveReport
+{
+    int empties; // before the move
+    char player;
+    int move;
+    std::string phase; // what chose the move: book, endgame, search, ...
+    double bookSeconds; // looking the position up, even when it missed
+    double thinkSeconds; // in phase
+    long long nodes; // or playouts for mcts
+    long long expanded, movesGenerated, evaluations;
+    long long ttProbes, ttHits;
+    int depth; // completed search depth, empties solved by the endgame
+    int threads;
+
+    // Average legal moves of the nodes the search expanded
+    double branching() const {
+        return expanded ? (double)movesGenerated / expanded : 0;
+    }
+};
+
+// The moves of one agent in one game, exported once the game is over
+class GameStats
+{
+    std::vector<MoveReport> moves;
+
+public:
+    GameStats() {}
+    ~GameStats() {}
+
+    void clear() {moves.clear();}
+    void add(const MoveReport &move) {moves.push_back(move);}
+    const std::vector<MoveReport> &getMoves() const {return moves;}
+
+    // One object, a "moves" array of one object per move
+    void writeJSON(std::ostream &out) const;
+    // A header line, then one line per move
+    void writeCSV(std::ostream &out) const;
+    // CSV if path ends with .csv, JSON otherwise; false if it cannot be
+    // written
+    bool save(const std::string &path) const;
+    // Totals and a line per move, for people
+    void print(std::ostream &out=std::cout) const;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include <iostream>
+#include <string>
+#include "Agent.hpp"
+
+#ifndef _TOURNAMENT_HPP
+#define _TOURNAMENT_HPP
+
+// Outcome of a tournament from the first agent's point of view
+struct TournamentResult
+{
+    int games, wins, draws, losses;
+    long long discs; // sum of the final disc differentials
+    double seconds;
+};
+
+// Headless games between two agents on a pool of threads. The agents swap
+// colours every game and nothing is printed while the games run.
+class Tournament
+{
+    int edgeSize, nGames, threads;
+    std::string firstName, secondName;
+    AgentSpec first, second;
+    // Shared by all the agents, optional
+    const OpeningBook *book;
+    const PatternEval *eval;
+
+    // Final score() of one game, agent playing black
+    int playGame(const AgentSpec &black, const AgentSpec &white,
+                 unsigned seed) const;
+
+public:
+    Tournament() = delete;
+    Tournament(int edgeSize, const std::string &firstName,
+               const AgentSpec &first, const std::string &secondName,
+               const AgentSpec &second, int nGames, int threads=1,
+               const OpeningBook *book=nullptr,
+               const PatternEval *eval=nullptr);
+    ~Tournament() {}
+
+    TournamentResult run() const;
+    void printResult(const TournamentResult &result,
+                     std::ostream &out=std::cout) const;
+};
+
+#endif
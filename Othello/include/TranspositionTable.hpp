@@ -0,0 +1,84 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "Stats.hpp"
+
+#ifndef _TRANSPOSITION_TABLE_HPP
+#define _TRANSPOSITION_TABLE_HPP
+
+#define TT_DEFAULT_MB 16
+#define TT_BUCKET_SIZE 4 // entries per 64-byte cache line
+
+enum Bound: uint8_t {BOUND_NONE, BOUND_EXACT, BOUND_LOWER, BOUND_UPPER};
+
+struct TTEntry
+{
+    uint64_t key;
+    int32_t score;
+    int16_t move; // best or refuting move, PASSING_MOVE if unknown
+    int8_t depth;
+    Bound bound;
+};
+
+// An entry packed into two words. Threads share the table without locks:
+// check holds key ^ data, so a slot torn by concurrent writers fails the key
+// test instead of returning another position's data.
+struct TTSlot
+{
+    std::atomic<uint64_t> check, data;
+};
+
+struct alignas(64) TTBucket
+{
+    TTSlot slots[TT_BUCKET_SIZE];
+};
+
+// Counters of one thread, padded so that threads do not share a cache line
+struct alignas(64) TTCounters
+{
+    long long probes, hits, stores, collisions;
+};
+
+// Fixed-size hash table of search results keyed by OthelloBoard::getHash().
+// Each key maps to one bucket, so a probe touches a single cache line.
+class TranspositionTable
+{
+    std::vector<TTBucket> buckets;
+    uint64_t mask; // buckets.size() - 1
+
+    // Statistics since the last clear(), one set per searching thread;
+    // zero without OTHELLO_STATS
+    std::vector<TTCounters> counters;
+
+    long long sum(long long TTCounters::*counter) const;
+
+public:
+    TranspositionTable(size_t megabytes=TT_DEFAULT_MB);
+    ~TranspositionTable() {}
+
+    void clear();
+    // Makes room for the counters of threads 0 to threads - 1,
+    // not to be called while a search runs
+    void setThreads(int threads);
+    // Copies the entry of key into entry, returns false if there is none
+    bool probe(uint64_t key, TTEntry &entry, int thread=0);
+    void store(uint64_t key, int score, int move, int depth, Bound bound,
+               int thread=0);
+
+    size_t getCapacity() const {return buckets.size() * TT_BUCKET_SIZE;}
+    long long getProbes() const {return sum(&TTCounters::probes);}
+    long long getHits() const {return sum(&TTCounters::hits);}
+    long long getStores() const {return sum(&TTCounters::stores);}
+    // Stores that evicted an entry of a different position
+    long long getCollisions() const {return sum(&TTCounters::collisions);}
+    double getHitRate() const {
+        long long probes = getProbes();
+        return probes ? (double)getHits() / probes : 0;
+    }
+    // Fraction of occupied entries, sampled from the first buckets
+    double getFill() const;
+    void printStats(std::ostream &out=std::cout) const;
+};
+
+#endif
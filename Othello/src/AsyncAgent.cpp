@@ -0,0 +1,114 @@
+#include "AsyncAgent.hpp"
+
+using namespace std;
+
+AsyncAgent::AsyncAgent(const AgentSpec &spec, int edgeSize, unsigned seed,
+                       const OpeningBook *book, const PatternEval *eval)
+    : board(edgeSize), agent(spec, board, false, seed, book, eval) {
+    stop = false;
+    task = running = IDLE;
+    generation = 0;
+    forced = false;
+    ready = false;
+    result = PASSING_MOVE;
+    agent.setStop(&stop);
+    worker = thread(&AsyncAgent::run, this);
+}
+
+AsyncAgent::~AsyncAgent() {
+    {
+        lock_guard<mutex> lock(taskMutex);
+        task = QUIT;
+        stop = true;
+        wake.notify_one();
+    }
+    worker.join();
+}
+
+void AsyncAgent::run() {
+    unique_lock<mutex> lock(taskMutex);
+    while (true) {
+        wake.wait(lock, [this] {return task != IDLE;});
+        if (task == QUIT) {
+            return;
+        }
+        Task current = task;
+        unsigned id = generation;
+        board.setPosition(position);
+        running = current;
+        task = IDLE;
+        stop = forced;
+        forced = false;
+        lock.unlock();
+
+        board.exploreMoves();
+        int move = PASSING_MOVE;
+        if (current == THINK) {
+            move = agent.getMove();
+        } else {
+            agent.ponder();
+        }
+
+        lock.lock();
+        running = IDLE;
+        if (current == THINK && id == generation) {
+            result = move;
+            ready = true;
+        }
+    }
+}
+
+// Replaces the pending task, if any, and stops the running one
+void AsyncAgent::start(Task next, const OthelloBoard &from) {
+    lock_guard<mutex> lock(taskMutex);
+    ++generation;
+    task = next;
+    position = from.getPosition();
+    forced = false;
+    ready = false;
+    stop = true;
+    wake.notify_one();
+}
+
+void AsyncAgent::think(const OthelloBoard &from) {
+    start(THINK, from);
+}
+
+void AsyncAgent::ponder(const OthelloBoard &from) {
+    start(PONDER, from);
+}
+
+bool AsyncAgent::poll(int &move) {
+    lock_guard<mutex> lock(taskMutex);
+    if (!ready) {
+        return false;
+    }
+    move = result;
+    ready = false;
+    return true;
+}
+
+void AsyncAgent::forceMove() {
+    lock_guard<mutex> lock(taskMutex);
+    if (task == THINK) {
+        forced = true;
+    } else if (running == THINK) {
+        stop = true;
+    }
+}
+
+void AsyncAgent::cancel() {
+    lock_guard<mutex> lock(taskMutex);
+    ++generation;
+    if (task != QUIT) {
+        task = IDLE;
+    }
+    forced = false;
+    ready = false;
+    stop = true;
+}
+
+bool AsyncAgent::isThinking() {
+    lock_guard<mutex> lock(taskMutex);
+    return task == THINK || (running == THINK && !ready);
+}
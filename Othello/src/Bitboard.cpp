@@ -0,0 +1,174 @@
+#include "Bitboard.hpp"
+
+template <typename B>
+BitboardGen<B>::BitboardGen(int edgeSize) {
+    this->edgeSize = edgeSize;
+    nCells = edgeSize * edgeSize;
+
+    B zero = {};
+    full = notFirstCol = notLastCol = zero;
+    for (int pos = 0; pos < nCells; ++pos) {
+        B bit = bitAt(zero, pos);
+        full |= bit;
+        if (pos % edgeSize != 0) {
+            notFirstCol |= bit;
+        }
+        if ((pos + 1) % edgeSize != 0) {
+            notLastCol |= bit;
+        }
+    }
+}
+
+template <typename B>
+B BitboardGen<B>::shift(const B &b, int dir) const {
+    switch (dir) {
+        case EAST: return (b << 1) & notFirstCol & full;
+        case WEST: return (b >> 1) & notLastCol;
+        case SOUTH: return (b << edgeSize) & full;
+        case NORTH: return b >> edgeSize;
+        case SOUTH_EAST: return (b << (edgeSize + 1)) & notFirstCol & full;
+        case SOUTH_WEST: return (b << (edgeSize - 1)) & notLastCol & full;
+        case NORTH_EAST: return (b >> (edgeSize - 1)) & notFirstCol;
+        default: return (b >> (edgeSize + 1)) & notLastCol; // NORTH_WEST
+    }
+}
+
+template <typename B>
+B BitboardGen<B>::legal(const B &own, const B &opp) const {
+    B moves = {};
+    B empty = ~(own | opp) & full;
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+        // A line holds at most edgeSize - 2 discs to flip
+        B run = shift(own, dir) & opp;
+        for (int i = 3; i < edgeSize; ++i) {
+            run |= shift(run, dir) & opp;
+        }
+        moves |= shift(run, dir);
+    }
+    return moves & empty;
+}
+
+template <typename B>
+B BitboardGen<B>::flips(const B &own, const B &opp, int pos) const {
+    B result = {};
+    B start = bitAt(result, pos);
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+        B line = {};
+        B cur = shift(start, dir);
+        while (bitAny(cur & opp)) {
+            line |= cur;
+            cur = shift(cur, dir);
+        }
+        if (bitAny(cur & own)) {
+            result |= line;
+        }
+    }
+    return result;
+}
+
+template <typename B>
+int BitboardGen<B>::lines(const B &own, const B &opp, int pos,
+                          uint8_t counts[N_DIRECTIONS]) const {
+    int total = 0;
+    B start = bitAt(own, pos);
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+        int n = 0;
+        B cur = shift(start, dir);
+        while (bitAny(cur & opp)) {
+            ++n;
+            cur = shift(cur, dir);
+        }
+        counts[dir] = bitAny(cur & own) ? n : 0;
+        total += counts[dir];
+    }
+    return total;
+}
+
+template class BitboardGen<Bits>;
+template class BitboardGen<WideBits>;
+
+template <int N>
+template <int Dir>
+typename FixedGen<N>::B FixedGen<N>::shift(const B &b) {
+    switch (Dir) {
+        case EAST: return (b << 1) & notFirstCol & full;
+        case WEST: return (b >> 1) & notLastCol;
+        case SOUTH: return (b << N) & full;
+        case NORTH: return b >> N;
+        case SOUTH_EAST: return (b << (N + 1)) & notFirstCol & full;
+        case SOUTH_WEST: return (b << (N - 1)) & notLastCol & full;
+        case NORTH_EAST: return (b >> (N - 1)) & notFirstCol;
+        default: return (b >> (N + 1)) & notLastCol; // NORTH_WEST
+    }
+}
+
+template <int N>
+template <int Dir>
+typename FixedGen<N>::B FixedGen<N>::run(const B &opp, const B &start) {
+    // A line holds at most N - 2 discs to flip
+    B cells = shift<Dir>(start) & opp;
+    for (int i = 3; i < N; ++i) {
+        cells |= shift<Dir>(cells) & opp;
+    }
+    return cells;
+}
+
+template <int N>
+template <int Dir>
+typename FixedGen<N>::B FixedGen<N>::closedRun(const B &own,
+                                               const B &opp,
+                                               const B &start) {
+    B cells = run<Dir>(opp, start);
+    return bitAny(shift<Dir>(cells) & own) ? cells : B{};
+}
+
+template <int N>
+typename FixedGen<N>::B FixedGen<N>::legal(const B &own, const B &opp) {
+    B moves = shift<EAST>(run<EAST>(opp, own)) |
+              shift<WEST>(run<WEST>(opp, own)) |
+              shift<SOUTH>(run<SOUTH>(opp, own)) |
+              shift<NORTH>(run<NORTH>(opp, own)) |
+              shift<SOUTH_EAST>(run<SOUTH_EAST>(opp, own)) |
+              shift<SOUTH_WEST>(run<SOUTH_WEST>(opp, own)) |
+              shift<NORTH_EAST>(run<NORTH_EAST>(opp, own)) |
+              shift<NORTH_WEST>(run<NORTH_WEST>(opp, own));
+    return moves & ~(own | opp) & full;
+}
+
+template <int N>
+typename FixedGen<N>::B FixedGen<N>::flips(const B &own, const B &opp,
+                                           int pos) {
+    B start = bitAt(own, pos);
+    return closedRun<EAST>(own, opp, start) |
+           closedRun<WEST>(own, opp, start) |
+           closedRun<SOUTH>(own, opp, start) |
+           closedRun<NORTH>(own, opp, start) |
+           closedRun<SOUTH_EAST>(own, opp, start) |
+           closedRun<SOUTH_WEST>(own, opp, start) |
+           closedRun<NORTH_EAST>(own, opp, start) |
+           closedRun<NORTH_WEST>(own, opp, start);
+}
+
+template <int N>
+int FixedGen<N>::lines(const B &own, const B &opp, int pos,
+                       uint8_t counts[N_DIRECTIONS]) {
+    B start = bitAt(own, pos);
+    counts[EAST] = bitCount(closedRun<EAST>(own, opp, start));
+    counts[WEST] = bitCount(closedRun<WEST>(own, opp, start));
+    counts[SOUTH] = bitCount(closedRun<SOUTH>(own, opp, start));
+    counts[NORTH] = bitCount(closedRun<NORTH>(own, opp, start));
+    counts[SOUTH_EAST] = bitCount(closedRun<SOUTH_EAST>(own, opp, start));
+    counts[SOUTH_WEST] = bitCount(closedRun<SOUTH_WEST>(own, opp, start));
+    counts[NORTH_EAST] = bitCount(closedRun<NORTH_EAST>(own, opp, start));
+    counts[NORTH_WEST] = bitCount(closedRun<NORTH_WEST>(own, opp, start));
+    int total = 0;
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+        total += counts[dir];
+    }
+    return total;
+}
+
+template class FixedGen<4>;
+template class FixedGen<6>;
+template class FixedGen<8>;
+template class FixedGen<10>;
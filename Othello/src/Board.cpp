@@ -1,12 +1,42 @@
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include "Board.hpp"
+#include "Search.hpp"
 
 using namespace std;
 
-const int INF = std::numeric_limits<int>::max();
-const int nINF = std::numeric_limits<int>::min(); // negative infinity
+// Row and column steps in the order of Direction
+static const int DIRECTION_ROWS[N_DIRECTIONS] = {0, 0, 1, -1, 1, 1, -1, -1};
+static const int DIRECTION_COLS[N_DIRECTIONS] = {1, -1, 0, 0, 1, -1, 1, -1};
 
+// splitmix64 finaliser, a fixed seed keeps hashes stable between runs
+static uint64_t zobristMix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+struct ZobristTable
+{
+    uint64_t keys[ZOBRIST_TABLE_CELLS][2];
+    ZobristTable() {
+        for (int pos = 0; pos < ZOBRIST_TABLE_CELLS; ++pos) {
+            keys[pos][0] = zobristMix(2 * pos);
+            keys[pos][1] = zobristMix(2 * pos + 1);
+        }
+    }
+};
+static const ZobristTable zobristTable;
+
+uint64_t zobristKey(int pos, char cell) {
+    int color = cell == WHITE;
+    if (pos < ZOBRIST_TABLE_CELLS) {
+        return zobristTable.keys[pos][color];
+    }
+    return zobristMix(2 * pos + color);
+}
 
 void printVector(const std::vector<int> &v) {
     if (v.empty()) {
@@ -19,17 +49,6 @@ void printVector(const std::vector<int> &v) {
     std::cout << std::endl;
 }
 
-void printMovesMap(const MovesMap &moves) {
-    if (moves.empty()) {
-        std::cout << "<empty map>" << std::endl;
-        return;
-    }
-    for (const auto &[moves, flips]: moves) {
-        std::cout << "[" << moves << "]: ";
-        printVector(flips);
-    }
-}
-
 SquareBoard::SquareBoard(int edgeSize) {
     this->edgeSize = edgeSize;
     nCells = edgeSize * edgeSize;
@@ -82,90 +101,353 @@ bool SquareBoard::put(int pos, char cell) {
     return true;
 }
 
-OthelloBoard::OthelloBoard(int edgeSize, char player)
-                           : SquareBoard::SquareBoard(edgeSize) {
-    if (edgeSize < MINIMUM_OTHELLO_BOARD_SIZE) {
-        cerr << "Minimum Othello board size is " << MINIMUM_OTHELLO_BOARD_SIZE
-             << endl;
-        exit(1);
+// The nearest size OthelloBoard::supports(), with a message on cerr if
+// that is not edgeSize
+static int supportedSize(int edgeSize) {
+    if (OthelloBoard::supports(edgeSize)) {
+        return edgeSize;
     }
+    int size = max(MINIMUM_OTHELLO_BOARD_SIZE,
+                   min(edgeSize, MAXIMUM_OTHELLO_BOARD_SIZE));
+    cerr << "Othello boards are " << MINIMUM_OTHELLO_BOARD_SIZE << "x"
+         << MINIMUM_OTHELLO_BOARD_SIZE << " to " << MAXIMUM_OTHELLO_BOARD_SIZE
+         << "x" << MAXIMUM_OTHELLO_BOARD_SIZE << ", not " << edgeSize << "x"
+         << edgeSize << "; playing on " << size << "x" << size << endl;
+    return size;
+}
 
-    setPlayer(player);
+// Generators of the width that does not fit the board are built clamped and
+// never used. Callers check supports(), a size it refuses is reported and
+// clamped.
+OthelloBoard::OthelloBoard(int size, char player)
+                           : SquareBoard::SquareBoard(supportedSize(size)),
+                             // a game has at most nCells moves and as many
+                             // passes; flips rarely exceed edgeSize a move
+                             undo(2 * edgeSize * edgeSize,
+                                  edgeSize * edgeSize * edgeSize),
+                             narrowGen(min(edgeSize, BITBOARD_NARROW_EDGE)),
+                             wideGen(min(edgeSize, BITBOARD_MAX_EDGE)) {
+
+    // In the order of Direction
+    int directionOffsets[N_DIRECTIONS] = {1, -1, edgeSize, -edgeSize,
+                                          edgeSize + 1, edgeSize - 1,
+                                          -edgeSize + 1, -edgeSize - 1};
+    copy(directionOffsets, directionOffsets + N_DIRECTIONS, offsets);
 
-    blackCount = 2;
-    whiteCount = 2;
+    setPlayer(player);
 
     int start = (edgeSize + 1) * (edgeSize / 2 - 1);
     put(start, WHITE);
     put(start + 1, BLACK);
     put(start + edgeSize, BLACK);
     put(start + edgeSize + 1, WHITE);
+    syncCells();
+}
+
+int OthelloBoard::edgeSizeOf(const string &position) {
+    int rows = 1 + count(position.begin(), position.end(), '/');
+    size_t end = position.find(' ');
+    int length = (end == string::npos ? position.size() : end) - (rows - 1);
+    return rows >= MINIMUM_OTHELLO_BOARD_SIZE && length == rows * rows ? rows
+                                                                       : 0;
+}
+
+bool OthelloBoard::setPosition(const string &position) {
+    if (edgeSizeOf(position) != edgeSize) {
+        return false;
+    }
+    size_t end = position.find(' ');
+    char side = end == string::npos ? (char)BLACK : position[end + 1];
+    if (side != BLACK && side != WHITE) {
+        return false;
+    }
+
+    vector<char> parsed;
+    for (size_t i = 0; i < position.size() && i != end; ++i) {
+        char cell = position[i];
+        if (cell == '/') {
+            continue;
+        }
+        if (cell != EMPTY && cell != BLACK && cell != WHITE) {
+            return false;
+        }
+        parsed.push_back(cell);
+    }
+
+    cells = parsed;
+    setPlayer(side);
+    syncCells();
+    return true;
+}
+
+string OthelloBoard::getPosition() const {
+    string position;
+    for (int pos = 0; pos < nCells; ++pos) {
+        if (pos > 0 && pos % edgeSize == 0) {
+            position += '/';
+        }
+        position += cells[pos];
+    }
+    return position + ' ' + player;
+}
+
+// Recomputes the counters, bitboards and hash from cells
+void OthelloBoard::syncCells() {
+    blackCount = count(cells.begin(), cells.end(), BLACK);
+    whiteCount = count(cells.begin(), cells.end(), WHITE);
+    syncBits();
+
+    hash = 0;
+    for (int pos = 0; pos < nCells; ++pos) {
+        if (cells[pos] != EMPTY) {
+            hash ^= zobristKey(pos, cells[pos]);
+        }
+    }
+
+    moves.clear();
+    undo.records.clear();
+    undo.flips.clear();
+    syncLegal();
+}
+
+void OthelloBoard::syncBits() {
+    blackBits = whiteBits = WideBits();
+    if (edgeSize > BITBOARD_MAX_EDGE) {
+        return;
+    }
+    for (int pos = 0; pos < nCells; ++pos) {
+        setBit(pos, cells[pos]);
+    }
+}
+
+void OthelloBoard::setBit(int pos, char cell) {
+    WideBits bit = bitAt(blackBits, pos);
+    if (cell == BLACK) {
+        blackBits |= bit;
+        whiteBits &= ~bit;
+    } else if (cell == WHITE) {
+        whiteBits |= bit;
+        blackBits &= ~bit;
+    }
 }
 
 void OthelloBoard::printMoves() const {
     std::cout << "Possible moves:" << std::endl;
-    printMovesMap(moves);
+    if (moves.empty()) {
+        std::cout << "<no moves>" << std::endl;
+        return;
+    }
+    for (const Move &move: moves) {
+        vector<int> flips;
+        for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+            for (int i = 1; i <= move.lines[dir]; ++i) {
+                flips.push_back(move.to + i * offsets[dir]);
+            }
+        }
+        std::cout << "[" << move.to << "]: ";
+        printVector(flips);
+    }
 }
 
-bool OthelloBoard::isGameOver() {
-    if (moves.size() != 0) {
-        return false;
+bool OthelloBoard::isGameOver() const {
+    return countMovesOf(player) == 0 &&
+           countMovesOf(player == BLACK ? WHITE : BLACK) == 0;
+}
+
+// Cell scanner for boards too big for the bitboard backend, same as
+// BitboardGen::lines for side
+int OthelloBoard::scanLines(int to, uint8_t counts[N_DIRECTIONS],
+                            char side) const {
+    char opponent = side == BLACK ? WHITE : BLACK;
+    int row = to / edgeSize, col = to % edgeSize, total = 0;
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+        int dr = DIRECTION_ROWS[dir], dc = DIRECTION_COLS[dir];
+        int r = row + dr, c = col + dc, n = 0;
+        for (; 0 <= r && r < edgeSize && 0 <= c && c < edgeSize &&
+               cells[r * edgeSize + c] == opponent; r += dr, c += dc) {
+            ++n;
+        }
+        bool closed = 0 <= r && r < edgeSize && 0 <= c && c < edgeSize &&
+                      cells[r * edgeSize + c] == side;
+        counts[dir] = closed ? n : 0;
+        total += counts[dir];
     }
+    return total;
+}
 
-    exploreMoves();
-    int curPlayerNMoves = moves.size();
+// scanLines() > 0 without counting, to must be empty
+bool OthelloBoard::isLegal(int to, char side) const {
+    char opponent = side == BLACK ? WHITE : BLACK;
+    int row = to / edgeSize, col = to % edgeSize;
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+        int dr = DIRECTION_ROWS[dir], dc = DIRECTION_COLS[dir];
+        int r = row + dr, c = col + dc;
+        if (r < 0 || r >= edgeSize || c < 0 || c >= edgeSize ||
+            cells[r * edgeSize + c] != opponent) {
+            continue;
+        }
+        do {
+            r += dr;
+            c += dc;
+        } while (0 <= r && r < edgeSize && 0 <= c && c < edgeSize &&
+                 cells[r * edgeSize + c] == opponent);
+        if (0 <= r && r < edgeSize && 0 <= c && c < edgeSize &&
+            cells[r * edgeSize + c] == side) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    changePlayer(); // change to opponent
-    exploreMoves();
-    int opponentNMoves = moves.size();
+void OthelloBoard::setLegal(int side, int pos, bool legal) {
+    uint64_t &word = legalCells[side][pos >> 6];
+    uint64_t bit = 1ULL << (pos & 63);
+    if (((word & bit) != 0) != legal) {
+        word ^= bit;
+        mobility[side] += legal ? 1 : -1;
+    }
+}
 
-    changePlayer(); // change back to the current player
-    return curPlayerNMoves == 0 && opponentNMoves == 0;
+void OthelloBoard::syncLegal() {
+    mobility[0] = mobility[1] = 0;
+    for (int side = 0; side < 2; ++side) {
+        legalCells[side].assign(scanned() ? (nCells + 63) / 64 : 0, 0);
+    }
+    refreshed.assign(scanned() ? nCells : 0, 0);
+    updates = 0;
+    if (!scanned()) {
+        return;
+    }
+    for (int pos = 0; pos < nCells; ++pos) {
+        if (cells[pos] == EMPTY) {
+            setLegal(0, pos, isLegal(pos, BLACK));
+            setLegal(1, pos, isLegal(pos, WHITE));
+        }
+    }
 }
 
-void OthelloBoard::exploreDirection(int cellPos, int inc) {
-    vector<int> flips; // positions of the discs to flip
-    char opponent = player == BLACK ? WHITE : BLACK;
-    int pos = cellPos + inc;
-    for (; ((inc < 0 &&  /* upper-left */
-             pos >= 0 && /* upper border */
-             pos % edgeSize != 0) || /* left border */
-            (inc > 0 && /* bottom-right */
-             pos < nCells && /* bottom border */
-             (pos + 1) % edgeSize != 0)) && /* right border */
-            cells[pos] == opponent; /* still on line */
-            pos += inc) {
-        flips.push_back(pos);
+// Only a changed cell and the first empty cell past the discs next to it
+// in each direction can see their lines through it change. The flips of a
+// move share most of those cells, each one is looked at once.
+void OthelloBoard::updateLegal(int to, const int *flips, int nFlips) {
+    if (++updates == 0) { // the stamps wrapped around
+        fill(refreshed.begin(), refreshed.end(), 0);
+        updates = 1;
     }
-    // advanced more than once and found an empty cell
-    if (pos - cellPos != inc && cells[pos] == EMPTY) {
-        moves[pos].insert(moves[pos].end(), flips.begin(), flips.end());
+    auto refresh = [this](int cell) {
+        if (refreshed[cell] == updates) {
+            return;
+        }
+        refreshed[cell] = updates;
+        bool empty = cells[cell] == EMPTY;
+        setLegal(0, cell, empty && isLegal(cell, BLACK));
+        setLegal(1, cell, empty && isLegal(cell, WHITE));
+    };
+    for (int i = -1; i < nFlips; ++i) {
+        int pos = i < 0 ? to : flips[i];
+        refresh(pos);
+        int row = pos / edgeSize, col = pos % edgeSize;
+        for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+            int dr = DIRECTION_ROWS[dir], dc = DIRECTION_COLS[dir];
+            int r = row + dr, c = col + dc;
+            while (0 <= r && r < edgeSize && 0 <= c && c < edgeSize &&
+                   cells[r * edgeSize + c] != EMPTY) {
+                r += dr;
+                c += dc;
+            }
+            if (0 <= r && r < edgeSize && 0 <= c && c < edgeSize) {
+                refresh(r * edgeSize + c);
+            }
+        }
+    }
+}
+
+int OthelloBoard::countFlips(int to) const {
+    uint8_t counts[N_DIRECTIONS];
+    return scanLines(to, counts, player);
+}
+
+template <typename Gen>
+void OthelloBoard::exploreBits(const Gen &gen, const WideBits &ownBits,
+                               const WideBits &oppBits) {
+    typename Gen::Bitset own, opp;
+    bitLow(ownBits, own);
+    bitLow(oppBits, opp);
+    typename Gen::Bitset legal = gen.legal(own, opp);
+    while (bitAny(legal)) {
+        int to = bitPopLowest(legal);
+        Move &move = moves.add(to);
+        move.score = gen.lines(own, opp, to, move.lines);
     }
 }
 
 void OthelloBoard::exploreMoves() {
-    static size_t cellPos = 0; // index for player cell iteration
     moves.clear();
-    for (cellPos = 0; cellPos < nCells; ++cellPos){
-        if (cells[cellPos] != player) {
-            continue;
+
+    const WideBits &own = player == BLACK ? blackBits : whiteBits;
+    const WideBits &opp = player == BLACK ? whiteBits : blackBits;
+    switch (edgeSize) {
+        case 4: exploreBits(FixedGen<4>(), own, opp); return;
+        case 6: exploreBits(FixedGen<6>(), own, opp); return;
+        case 8: exploreBits(FixedGen<8>(), own, opp); return;
+        case 10: exploreBits(FixedGen<10>(), own, opp); return;
+    }
+    if (edgeSize <= BITBOARD_NARROW_EDGE) {
+        exploreBits(narrowGen, own, opp);
+        return;
+    }
+    if (edgeSize <= BITBOARD_MAX_EDGE) {
+        exploreBits(wideGen, own, opp);
+        return;
+    }
+
+    const vector<uint64_t> &legal = legalCells[player == WHITE];
+    for (int word = 0; word < (int)legal.size(); ++word) {
+        for (uint64_t bits = legal[word]; bits; bits &= bits - 1) {
+            int to = (word << 6) + __builtin_ctzll(bits);
+            Move &move = moves.add(to);
+            move.score = scanLines(to, move.lines, player);
         }
-        // Look left
-        exploreDirection(cellPos, -1);
-        // Look NW
-        exploreDirection(cellPos, -edgeSize - 1);
-        // Look up
-        exploreDirection(cellPos, -edgeSize);
-        // Look NE
-        exploreDirection(cellPos, -edgeSize + 1);
-        // Look right
-        exploreDirection(cellPos, 1);
-        // Look SE
-        exploreDirection(cellPos, edgeSize + 1);
-        // Look down
-        exploreDirection(cellPos, edgeSize);
-        // Look SW
-        exploreDirection(cellPos, edgeSize - 1);
+    }
+}
+
+template <typename Gen>
+int OthelloBoard::countBits(const Gen &gen, const WideBits &ownBits,
+                            const WideBits &oppBits) const {
+    typename Gen::Bitset own, opp;
+    bitLow(ownBits, own);
+    bitLow(oppBits, opp);
+    return bitCount(gen.legal(own, opp));
+}
+
+int OthelloBoard::countMoves() const {
+    return countMovesOf(player);
+}
+
+int OthelloBoard::countMovesOf(char side) const {
+    const WideBits &own = side == BLACK ? blackBits : whiteBits;
+    const WideBits &opp = side == BLACK ? whiteBits : blackBits;
+    switch (edgeSize) {
+        case 4: return countBits(FixedGen<4>(), own, opp);
+        case 6: return countBits(FixedGen<6>(), own, opp);
+        case 8: return countBits(FixedGen<8>(), own, opp);
+        case 10: return countBits(FixedGen<10>(), own, opp);
+    }
+    if (edgeSize <= BITBOARD_NARROW_EDGE) {
+        return countBits(narrowGen, own, opp);
+    }
+    if (edgeSize <= BITBOARD_MAX_EDGE) {
+        return countBits(wideGen, own, opp);
+    }
+    return mobility[side == WHITE];
+}
+
+// Turns the disc at pos to the player to move
+void OthelloBoard::flipDisc(int pos, char opponent) {
+    cells[pos] = player;
+    hash ^= zobristKey(pos, opponent) ^ zobristKey(pos, player);
+    if (edgeSize <= BITBOARD_MAX_EDGE) {
+        setBit(pos, player);
     }
 }
 
@@ -175,12 +457,22 @@ void OthelloBoard::move(int to) {
         return;
     }
 
+    char opponent = player == BLACK ? WHITE : BLACK;
     cells[to] = player;
-    for (const auto &flip: moves[to]) {
-        cells[flip] = player;
+    hash ^= zobristKey(to, player);
+    if (edgeSize <= BITBOARD_MAX_EDGE) {
+        setBit(to, player);
+    }
+    // A move that is not in moves flips nothing
+    const Move *move = moves.find(to);
+    int nFlips = 0;
+    for (int dir = 0; move && dir < N_DIRECTIONS; ++dir) {
+        for (int i = 1; i <= move->lines[dir]; ++i) {
+            flipDisc(to + i * offsets[dir], opponent);
+        }
+        nFlips += move->lines[dir];
     }
 
-    int nFlips = moves[to].size();
     if (player == BLACK) {
         blackCount += nFlips + 1;
         whiteCount -= nFlips;
@@ -188,40 +480,140 @@ void OthelloBoard::move(int to) {
         blackCount -= nFlips;
         whiteCount += nFlips + 1;
     }
+    if (scanned()) {
+        int flips[N_DIRECTIONS * MAXIMUM_OTHELLO_BOARD_SIZE], n = 0;
+        for (int dir = 0; move && dir < N_DIRECTIONS; ++dir) {
+            for (int i = 1; i <= move->lines[dir]; ++i) {
+                flips[n++] = to + i * offsets[dir];
+            }
+        }
+        updateLegal(to, flips, n);
+    }
 
     changePlayer();
 }
 
-int OthelloBoard::random() {
-    return moves.begin()->first;
+template <typename Gen>
+void OthelloBoard::collectBits(const Gen &gen, const WideBits &ownBits,
+                               const WideBits &oppBits, int to) {
+    typename Gen::Bitset own, opp;
+    bitLow(ownBits, own);
+    bitLow(oppBits, opp);
+    typename Gen::Bitset flips = gen.flips(own, opp, to);
+    while (bitAny(flips)) {
+        undo.flips.push_back(bitPopLowest(flips));
+    }
 }
 
-int OthelloBoard::greedy() {
-    int bestMove = PASSING_MOVE, bestLen = 0;
-    for (auto &[to, flips]: moves) {
-        if (flips.size() > bestLen) {
-            bestLen = flips.size();
-            bestMove = to;
+// Pushes the cells flipped by the player to move playing to onto undo.flips
+void OthelloBoard::collectFlips(int to) {
+    const WideBits &own = player == BLACK ? blackBits : whiteBits;
+    const WideBits &opp = player == BLACK ? whiteBits : blackBits;
+    switch (edgeSize) {
+        case 4: collectBits(FixedGen<4>(), own, opp, to); return;
+        case 6: collectBits(FixedGen<6>(), own, opp, to); return;
+        case 8: collectBits(FixedGen<8>(), own, opp, to); return;
+        case 10: collectBits(FixedGen<10>(), own, opp, to); return;
+    }
+    if (edgeSize <= BITBOARD_NARROW_EDGE) {
+        collectBits(narrowGen, own, opp, to);
+        return;
+    }
+    if (edgeSize <= BITBOARD_MAX_EDGE) {
+        collectBits(wideGen, own, opp, to);
+        return;
+    }
+
+    uint8_t counts[N_DIRECTIONS];
+    scanLines(to, counts, player);
+    for (int dir = 0; dir < N_DIRECTIONS; ++dir) {
+        for (int i = 1; i <= counts[dir]; ++i) {
+            undo.flips.push_back(to + i * offsets[dir]);
         }
     }
-    return bestMove;
 }
 
-// TODO
-int OthelloBoard::minimax() {
-    // int max = nINF, min = INF;
+int OthelloBoard::makeMove(int to) {
+    int flipsBegin = undo.flips.size();
+    undo.records.push_back({to, flipsBegin, blackCount, whiteCount, hash});
+    if (to == PASSING_MOVE) {
+        changePlayer();
+        return 0;
+    }
+
+    collectFlips(to);
+    char opponent = player == BLACK ? WHITE : BLACK;
+    cells[to] = player;
+    hash ^= zobristKey(to, player);
+    if (edgeSize <= BITBOARD_MAX_EDGE) {
+        setBit(to, player);
+    }
+    int nFlips = undo.flips.size() - flipsBegin;
+    for (int i = flipsBegin, e = undo.flips.size(); i < e; ++i) {
+        flipDisc(undo.flips[i], opponent);
+    }
+    if (scanned()) {
+        updateLegal(to, &undo.flips[flipsBegin], nFlips);
+    }
+
+    if (player == BLACK) {
+        blackCount += nFlips + 1;
+        whiteCount -= nFlips;
+    } else {
+        blackCount -= nFlips;
+        whiteCount += nFlips + 1;
+    }
+    changePlayer();
+    return nFlips;
+}
 
-    // int i,j,value = 1;
+void OthelloBoard::unmakeMove() {
+    UndoRecord &record = undo.records.back();
+    changePlayer(); // back to the player who moved
+    if (record.move != PASSING_MOVE) {
+        bool bits = edgeSize <= BITBOARD_MAX_EDGE;
+        char opponent = player == BLACK ? WHITE : BLACK;
+        cells[record.move] = EMPTY;
+        if (bits) {
+            WideBits bit = bitAt(blackBits, record.move);
+            blackBits &= ~bit;
+            whiteBits &= ~bit;
+        }
+        for (int i = record.flipsBegin, e = undo.flips.size(); i < e; ++i) {
+            cells[undo.flips[i]] = opponent;
+            if (bits) {
+                setBit(undo.flips[i], opponent);
+            }
+        }
+        if (scanned()) {
+            updateLegal(record.move, undo.flips.data() + record.flipsBegin,
+                        undo.flips.size() - record.flipsBegin);
+        }
+        undo.flips.resize(record.flipsBegin);
+    }
+    blackCount = record.blackCount;
+    whiteCount = record.whiteCount;
+    hash = record.hash;
+    undo.records.pop_back();
+}
 
-    // if (isGameOver()) {
-    //     return score();
-    // }
+int OthelloBoard::random(unsigned r) const {
+    return moves.empty() ? PASSING_MOVE : moves[r % moves.size()].to;
+}
 
-    // vector<int> scores(moves.size(), 0);
-    // for (auto &[move, flips]: moves) {
-    //     cout << "Making move " << move << endl;
-    //     this->move(move);
-    // }
+int OthelloBoard::greedy() {
+    int bestMove = PASSING_MOVE, bestLen = 0;
+    for (const Move &move: moves) {
+        int flips = move.flips();
+        if (flips > bestLen) {
+            bestLen = flips;
+            bestMove = move.to;
+        }
+    }
+    return bestMove;
+}
 
-    // return 0;
+int OthelloBoard::minimax(int depth) {
+    Search search(depth);
+    return search.bestMove(*this);
 }
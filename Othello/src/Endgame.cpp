@@ -0,0 +1,281 @@
+#include <iomanip>
+#include "Endgame.hpp"
+
+using namespace std;
+using namespace chrono;
+
+#define ENDGAME_PARITY_BONUS 1
+#define ENDGAME_MOBILITY_WEIGHT 2
+
+EndgameSolver::EndgameSolver(int maxEmpties) {
+    this->maxEmpties = maxEmpties;
+    nodes = 0;
+    bestScore = 0;
+    elapsed = 0;
+    stats.assign(ENDGAME_STATS_EMPTIES + 1, EndgameStats{0, 0, 0});
+}
+
+double EndgameSolver::getNodesPerSecond() const {
+    return elapsed > 0 ? nodes / elapsed : 0;
+}
+
+void EndgameSolver::printStats(ostream &out) const {
+    out << "solved " << showpos << bestScore << noshowpos << ", " << nodes
+        << " nodes in " << elapsed << " s ("
+        << (long long)getNodesPerSecond() << " nodes/s)" << endl;
+}
+
+void EndgameSolver::printStatsByEmpties(ostream &out) const {
+    out << setw(8) << "empties" << setw(8) << "solves" << setw(14)
+        << "nodes" << setw(12) << "seconds" << setw(14) << "nodes/s"
+        << endl;
+    for (int n = 0; n <= ENDGAME_STATS_EMPTIES; ++n) {
+        const EndgameStats &s = stats[n];
+        if (s.solves == 0) {
+            continue;
+        }
+        out << setw(8) << n << setw(8) << s.solves << setw(14) << s.nodes
+            << setw(12) << fixed << setprecision(4) << s.seconds
+            << defaultfloat << setprecision(6) << setw(14)
+            << (long long)(s.seconds > 0 ? s.nodes / s.seconds : 0) << endl;
+    }
+}
+
+void EndgameSolver::record(const OthelloBoard &board,
+                           steady_clock::time_point startTime) {
+    elapsed = duration<double>(steady_clock::now() - startTime).count();
+    int nEmpties = board.getEmptyCount();
+    if (nEmpties <= ENDGAME_STATS_EMPTIES) {
+        stats[nEmpties].solves += 1;
+        stats[nEmpties].nodes += nodes;
+        stats[nEmpties].seconds += elapsed;
+    }
+}
+
+// Collects the empty cells and the quadrant of every cell
+void EndgameSolver::setRoot(OthelloBoard &board) {
+    const vector<char> &cells = board.getCells();
+    int edgeSize = board.getEdgeSize();
+
+    empties.clear();
+    quadrants.resize(cells.size());
+    for (int pos = 0; pos < (int)cells.size(); ++pos) {
+        int row = pos / edgeSize, col = pos % edgeSize;
+        quadrants[pos] = (2 * row >= edgeSize) * 2 + (2 * col >= edgeSize);
+        if (cells[pos] == EMPTY) {
+            empties.push_back(pos);
+        }
+    }
+    if (plyMoves.size() <= empties.size()) {
+        plyMoves.resize(empties.size() + 1);
+    }
+}
+
+// Bit q is set when quadrant q has an odd number of empty cells
+int EndgameSolver::parity(const vector<char> &cells) const {
+    int odd = 0;
+    for (int pos: empties) {
+        if (cells[pos] == EMPTY) {
+            odd ^= 1 << quadrants[pos];
+        }
+    }
+    return odd;
+}
+
+void EndgameSolver::orderMoves(OthelloBoard &board, MoveList &moves,
+                               int nEmpties) {
+    int odd = parity(board.getCells());
+    for (Move &move: moves) {
+        move.score = (odd >> quadrants[move.to]) & 1 ? ENDGAME_PARITY_BONUS
+                                                     : 0;
+        if (nEmpties >= ENDGAME_FASTEST_FIRST_EMPTIES) {
+            board.makeMove(move.to);
+            move.score -= ENDGAME_MOBILITY_WEIGHT * board.countMoves();
+            board.unmakeMove();
+        }
+    }
+    moves.sort();
+}
+
+// Disc differential from the point of view of the player to move
+int EndgameSolver::finalScore(const OthelloBoard &board) const {
+    return board.getPlayer() == BLACK ? board.score() : -board.score();
+}
+
+// One empty cell left: whoever can play it does, flipping discs straight
+// from the other side's count
+int EndgameSolver::solveLast(OthelloBoard &board) {
+    const vector<char> &cells = board.getCells();
+    int last = empties[0];
+    for (int pos: empties) {
+        if (cells[pos] == EMPTY) {
+            last = pos;
+            break;
+        }
+    }
+
+    int discs = finalScore(board);
+    int flips = board.countFlips(last);
+    if (flips > 0) {
+        return discs + 2 * flips + 1;
+    }
+    board.changePlayer();
+    flips = board.countFlips(last);
+    board.changePlayer();
+    if (flips > 0) {
+        return discs - 2 * flips - 1;
+    }
+    return discs;
+}
+
+// A few empty cells left: try them in parity order instead of generating
+// the moves
+int EndgameSolver::solveShallow(OthelloBoard &board, int alpha, int beta,
+                                bool passed) {
+    const vector<char> &cells = board.getCells();
+    int odd = parity(cells), candidates[ENDGAME_SHALLOW_EMPTIES], n = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int pos: empties) {
+            bool inOdd = (odd >> quadrants[pos]) & 1;
+            if (cells[pos] == EMPTY && inOdd == (pass == 0)) {
+                candidates[n++] = pos;
+            }
+        }
+    }
+
+    int best = -ENDGAME_INF;
+    for (int i = 0; i < n; ++i) {
+        if (board.countFlips(candidates[i]) == 0) {
+            continue;
+        }
+        board.makeMove(candidates[i]);
+        int value = -solve(board, -beta, -alpha, false);
+        board.unmakeMove();
+        if (value > best) {
+            best = value;
+            if (value > alpha) {
+                alpha = value;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+    if (best > -ENDGAME_INF) {
+        return best;
+    }
+
+    if (passed) { // neither side can move
+        return finalScore(board);
+    }
+    board.makeMove(PASSING_MOVE);
+    int value = -solve(board, -beta, -alpha, true);
+    board.unmakeMove();
+    return value;
+}
+
+int EndgameSolver::solve(OthelloBoard &board, int alpha, int beta,
+                         bool passed) {
+    ++nodes;
+    int nEmpties = board.getEmptyCount();
+    if (nEmpties == 0) {
+        return finalScore(board);
+    }
+    if (nEmpties == 1) {
+        return solveLast(board);
+    }
+    if (nEmpties <= ENDGAME_SHALLOW_EMPTIES) {
+        return solveShallow(board, alpha, beta, passed);
+    }
+
+    board.exploreMoves();
+    if (board.getMoves().empty()) {
+        if (passed) {
+            return finalScore(board);
+        }
+        board.makeMove(PASSING_MOVE);
+        int value = -solve(board, -beta, -alpha, true);
+        board.unmakeMove();
+        return value;
+    }
+
+    // Children overwrite the board's list, search the copy of this count
+    MoveList &moves = plyMoves[nEmpties];
+    moves = board.getMoves();
+    orderMoves(board, moves, nEmpties);
+
+    // Later moves only have to be proven worse than the best so far, with
+    // a null window, and are searched again if they are not
+    int best = -ENDGAME_INF;
+    for (const Move &move: moves) {
+        board.makeMove(move.to);
+        int value;
+        if (best == -ENDGAME_INF) {
+            value = -solve(board, -beta, -alpha, false);
+        } else {
+            value = -solve(board, -alpha - 1, -alpha, false);
+            if (alpha < value && value < beta) {
+                value = -solve(board, -beta, -value, false);
+            }
+        }
+        board.unmakeMove();
+        if (value > best) {
+            best = value;
+            if (value > alpha) {
+                alpha = value;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+int EndgameSolver::solve(const OthelloBoard &board) {
+    steady_clock::time_point startTime = steady_clock::now();
+    nodes = 0;
+
+    OthelloBoard root = board;
+    setRoot(root);
+    int value = solve(root, -ENDGAME_INF, ENDGAME_INF, false);
+    bestScore = board.getPlayer() == BLACK ? value : -value;
+
+    record(board, startTime);
+    return bestScore;
+}
+
+int EndgameSolver::bestMove(const OthelloBoard &board) {
+    steady_clock::time_point startTime = steady_clock::now();
+    nodes = 1;
+
+    OthelloBoard root = board;
+    setRoot(root);
+    root.exploreMoves();
+    if (root.getMoves().empty()) {
+        root.makeMove(PASSING_MOVE);
+        int value = -solve(root, -ENDGAME_INF, ENDGAME_INF, true);
+        root.unmakeMove();
+        bestScore = board.getPlayer() == BLACK ? value : -value;
+        record(board, startTime);
+        return PASSING_MOVE;
+    }
+
+    MoveList &moves = plyMoves[root.getEmptyCount()];
+    moves = root.getMoves();
+    orderMoves(root, moves, root.getEmptyCount());
+    int alpha = -ENDGAME_INF, best = moves[0].to;
+    for (const Move &move: moves) {
+        root.makeMove(move.to);
+        int value = -solve(root, -ENDGAME_INF, -alpha, false);
+        root.unmakeMove();
+        if (value > alpha) {
+            alpha = value;
+            best = move.to;
+        }
+    }
+    bestScore = board.getPlayer() == BLACK ? alpha : -alpha;
+
+    record(board, startTime);
+    return best;
+}
@@ -0,0 +1,392 @@
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+#include "GameData.hpp"
+#ifdef OTHELLO_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace std;
+
+// CRC-32 (IEEE), one table lookup per byte
+static uint32_t crc32Of(const char *data, size_t size) {
+    static uint32_t table[256];
+    static bool built = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)built;
+
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ (uint8_t)data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// 2 bits a cell
+static int cellCode(char cell) {
+    return cell == BLACK ? 1 : cell == WHITE ? 2 : 0;
+}
+
+static const char CELLS[4] = {EMPTY, BLACK, WHITE, EMPTY};
+
+template <typename T>
+static void appendBytes(vector<char> &out, const T *data, size_t count) {
+    const char *bytes = (const char *)data;
+    out.insert(out.end(), bytes, bytes + count * sizeof(T));
+}
+
+template <typename T>
+static bool parseBytes(const char *&data, const char *end, T *target,
+                       size_t count) {
+    size_t size = count * sizeof(T);
+    if ((size_t)(end - data) < size) {
+        return false;
+    }
+    memcpy(target, data, size);
+    data += size;
+    return true;
+}
+
+void GameRecord::clear(int edgeSize) {
+    this->edgeSize = edgeSize;
+    score = 0;
+    players.clear();
+    moves.clear();
+    cells.clear();
+}
+
+void GameRecord::add(const OthelloBoard &board, int move) {
+    const vector<char> &boardCells = board.getCells();
+    players.push_back(board.getPlayer());
+    moves.push_back(move);
+    size_t begin = cells.size();
+    cells.resize(begin + positionBytes(), 0);
+    for (size_t pos = 0; pos < boardCells.size(); ++pos) {
+        cells[begin + pos / 4] |= cellCode(boardCells[pos]) << (pos % 4 * 2);
+    }
+}
+
+void GameRecord::position(int ply, vector<char> &out) const {
+    out.resize(edgeSize * edgeSize);
+    const uint8_t *packed = &cells[ply * positionBytes()];
+    for (size_t pos = 0; pos < out.size(); ++pos) {
+        out[pos] = CELLS[(packed[pos / 4] >> (pos % 4 * 2)) & 3];
+    }
+}
+
+void GameRecord::append(vector<char> &out) const {
+    int16_t header[3] = {(int16_t)edgeSize, (int16_t)score,
+                         (int16_t)plies()};
+    appendBytes(out, header, 3);
+    appendBytes(out, players.data(), players.size());
+    appendBytes(out, moves.data(), moves.size());
+    appendBytes(out, cells.data(), cells.size());
+}
+
+bool GameRecord::parse(const char *&data, const char *end) {
+    int16_t header[3];
+    if (!parseBytes(data, end, header, 3) || header[0] <= 0 ||
+        header[0] > MAXIMUM_OTHELLO_BOARD_SIZE || header[2] < 0) {
+        return false;
+    }
+    clear(header[0]);
+    score = header[1];
+    int plies = header[2];
+    players.resize(plies);
+    moves.resize(plies);
+    cells.resize(plies * positionBytes());
+    return parseBytes(data, end, players.data(), players.size()) &&
+           parseBytes(data, end, moves.data(), moves.size()) &&
+           parseBytes(data, end, cells.data(), cells.size());
+}
+
+bool GameRecord::operator==(const GameRecord &other) const {
+    return edgeSize == other.edgeSize && score == other.score &&
+           players == other.players && moves == other.moves &&
+           cells == other.cells;
+}
+
+// Offset of the end of the chunks GameReader reads whole and unchanged,
+// from the chunk at the position of in to the end of the file at size
+static long long wholeChunksEnd(ifstream &in, long long size) {
+    long long end = in.tellg();
+    ChunkHeader header;
+    vector<char> payload;
+    while (in.read((char *)&header, sizeof(header)) &&
+           header.magic == GAMES_CHUNK_MAGIC &&
+           header.storedSize <= size - end - (long long)sizeof(header)) {
+        payload.resize(header.storedSize);
+        in.read(payload.data(), payload.size());
+        if (!in || crc32Of(payload.data(), payload.size()) != header.checksum) {
+            break;
+        }
+        end = in.tellg();
+    }
+    return end;
+}
+
+GameWriter::GameWriter() {
+    compress = false;
+    chunkBytes = GAMES_CHUNK_BYTES;
+    filling.games = 0;
+    closing = false;
+    failed = false;
+    games = chunks = rawBytes = storedBytes = 0;
+}
+
+bool GameWriter::canCompress() {
+#ifdef OTHELLO_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool GameWriter::open(const string &path, bool compress, size_t chunkBytes) {
+    close();
+    this->path = path;
+    this->compress = compress && canCompress();
+    this->chunkBytes = chunkBytes;
+    failed = false;
+    games = chunks = rawBytes = storedBytes = 0;
+
+    // An existing file must be a game file of this version, appending to
+    // it keeps what is there. GameReader stops at the first damaged chunk,
+    // so one cut short by a crash is dropped or it would hide the new ones.
+    GamesHeader header = {};
+    ifstream existing(path, ios::binary);
+    bool empty = !existing || existing.peek() == ifstream::traits_type::eof();
+    long long size = 0, end = 0;
+    if (!empty) {
+        existing.read((char *)&header, sizeof(header));
+        if (!existing || memcmp(header.magic, GAMES_MAGIC,
+                                sizeof(GAMES_MAGIC)) != 0 ||
+            header.version != GAMES_VERSION) {
+            cerr << path << " is not a game file" << endl;
+            return false;
+        }
+        existing.seekg(0, ios::end);
+        size = existing.tellg();
+        existing.seekg(sizeof(header));
+        end = wholeChunksEnd(existing, size);
+    }
+    existing.close();
+    if (end < size) {
+        cerr << path << ": dropping the " << size - end
+             << " bytes after the last whole chunk" << endl;
+        if (truncate(path.c_str(), end) != 0) {
+            cerr << "Cannot truncate the game file " << path << endl;
+            return false;
+        }
+    }
+
+    out.open(path, ios::binary | ios::app);
+    if (empty) {
+        header = {};
+        memcpy(header.magic, GAMES_MAGIC, sizeof(GAMES_MAGIC));
+        header.version = GAMES_VERSION;
+        out.write((const char *)&header, sizeof(header));
+    }
+    if (!out) {
+        cerr << "Cannot write the game file " << path << endl;
+        out.close();
+        return false;
+    }
+
+    closing = false;
+    filling.records.clear();
+    filling.records.reserve(chunkBytes);
+    filling.games = 0;
+    background = thread(&GameWriter::run, this);
+    return true;
+}
+
+void GameWriter::write(const GameRecord &record) {
+    vector<char> bytes;
+    record.append(bytes);
+
+    lock_guard<mutex> lock(queueMutex);
+    filling.records.insert(filling.records.end(), bytes.begin(), bytes.end());
+    ++filling.games;
+    if (filling.records.size() >= chunkBytes) {
+        queue.push_back(move(filling));
+        filling.records.clear();
+        filling.records.reserve(chunkBytes);
+        filling.games = 0;
+        ready.notify_one();
+    }
+}
+
+bool GameWriter::close() {
+    if (!background.joinable()) {
+        return !failed;
+    }
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (filling.games > 0) {
+            queue.push_back(move(filling));
+            filling.records.clear();
+            filling.games = 0;
+        }
+        closing = true;
+        ready.notify_one();
+    }
+    background.join();
+    out.close();
+    if (failed) {
+        cerr << "Cannot write the game file " << path << endl;
+    }
+    return !failed;
+}
+
+void GameWriter::run() {
+    vector<char> buffer; // compressed payload, reused
+    while (true) {
+        Chunk chunk;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            ready.wait(lock, [this] {return closing || !queue.empty();});
+            if (queue.empty()) {
+                return;
+            }
+            chunk = move(queue.front());
+            queue.pop_front();
+        }
+        writeChunk(chunk, buffer);
+    }
+}
+
+void GameWriter::writeChunk(Chunk &chunk, vector<char> &buffer) {
+    ChunkHeader header = {};
+    header.magic = GAMES_CHUNK_MAGIC;
+    header.rawSize = chunk.records.size();
+    header.games = chunk.games;
+    const char *payload = chunk.records.data();
+    size_t size = chunk.records.size();
+
+#ifdef OTHELLO_HAVE_ZLIB
+    // Kept raw when compressing does not pay
+    if (compress) {
+        uLongf compressed = compressBound(size);
+        buffer.resize(compressed);
+        if (compress2((Bytef *)buffer.data(), &compressed,
+                      (const Bytef *)payload, size,
+                      Z_DEFAULT_COMPRESSION) == Z_OK && compressed < size) {
+            header.flags |= GAMES_COMPRESSED;
+            payload = buffer.data();
+            size = compressed;
+        }
+    }
+#else
+    (void)buffer;
+#endif
+
+    header.storedSize = size;
+    header.checksum = crc32Of(payload, size);
+    out.write((const char *)&header, sizeof(header));
+    out.write(payload, size);
+    out.flush();
+    if (!out) {
+        failed = true;
+        return;
+    }
+    games += chunk.games;
+    ++chunks;
+    rawBytes += header.rawSize;
+    storedBytes += sizeof(header) + size;
+}
+
+bool GameReader::open(const string &path) {
+    this->path = path;
+    in.open(path, ios::binary);
+    records.clear();
+    offset = 0;
+    remaining = 0;
+    corrupt = false;
+
+    GamesHeader header;
+    in.read((char *)&header, sizeof(header));
+    if (!in || memcmp(header.magic, GAMES_MAGIC, sizeof(GAMES_MAGIC)) != 0 ||
+        header.version != GAMES_VERSION) {
+        cerr << path << " is not a game file" << endl;
+        in.close();
+        return false;
+    }
+    return true;
+}
+
+bool GameReader::readChunk() {
+    ChunkHeader header;
+    in.read((char *)&header, sizeof(header));
+    if (in.gcount() == 0) { // the end of the file
+        return false;
+    }
+    vector<char> payload;
+    if (in && header.magic == GAMES_CHUNK_MAGIC) {
+        payload.resize(header.storedSize);
+        in.read(payload.data(), payload.size());
+    }
+    if (!in || header.magic != GAMES_CHUNK_MAGIC) {
+        cerr << path << ": the last chunk is cut short" << endl;
+        corrupt = true;
+        return false;
+    }
+    if (crc32Of(payload.data(), payload.size()) != header.checksum) {
+        cerr << path << ": bad checksum at byte "
+             << (long long)in.tellg() - header.storedSize << endl;
+        corrupt = true;
+        return false;
+    }
+
+    if (header.flags & GAMES_COMPRESSED) {
+#ifdef OTHELLO_HAVE_ZLIB
+        records.resize(header.rawSize);
+        uLongf size = header.rawSize;
+        if (uncompress((Bytef *)records.data(), &size,
+                       (const Bytef *)payload.data(),
+                       payload.size()) != Z_OK || size != header.rawSize) {
+            cerr << path << ": cannot uncompress a chunk" << endl;
+            corrupt = true;
+            return false;
+        }
+#else
+        cerr << path << " is compressed, this build has no zlib" << endl;
+        corrupt = true;
+        return false;
+#endif
+    } else {
+        records.swap(payload);
+    }
+    offset = 0;
+    remaining = header.games;
+    return true;
+}
+
+bool GameReader::next(GameRecord &record) {
+    if (!in.is_open() || corrupt) {
+        return false;
+    }
+    while (remaining == 0) {
+        if (!readChunk()) {
+            return false;
+        }
+    }
+    const char *data = records.data() + offset;
+    const char *end = records.data() + records.size();
+    if (!record.parse(data, end)) {
+        cerr << path << ": bad game record" << endl;
+        corrupt = true;
+        return false;
+    }
+    offset = data - records.data();
+    --remaining;
+    return true;
+}
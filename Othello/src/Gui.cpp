@@ -1,3 +1,4 @@
+#include <cmath>
 #include <iostream>
 #include "Gui.hpp"
 
@@ -5,8 +6,10 @@ using namespace sf;
 using namespace std;
 
 
-Game::Game(OthelloBoard &board, const std::string windowName)
-        : board(board), boardGui(board.getEdgeSize()) {
+Game::Game(OthelloBoard &board, AsyncAgent *ai, char aiPlayer,
+           const std::string windowName)
+        : board(board), ai(ai), aiPlayer(aiPlayer), aiCancelled(false),
+          redraw(true), boardGui(board.getEdgeSize()) {
     // Center window
     VideoMode mode = VideoMode::getDesktopMode();
     int width = mode.width * WINDOW_SCALE, height = mode.height * WINDOW_SCALE;
@@ -24,43 +27,95 @@ Game::Game(OthelloBoard &board, const std::string windowName)
     boardGui.update(board.getCells());
 }
 
+bool Game::humanToMove() const {
+    return !ai || board.getPlayer() != aiPlayer || aiCancelled;
+}
+
+// The AI thinks on its turn and ponders on the human's
+void Game::startTurn() {
+    if (!ai) {
+        return;
+    }
+    if (humanToMove()) {
+        ai->ponder(board);
+    } else {
+        ai->think(board);
+    }
+}
+
+void Game::endTurn() {
+    redraw |= boardGui.update(board.getCells());
+    aiCancelled = false;
+    if (board.isGameOver()) {
+        closeWindow();
+        return;
+    }
+    board.exploreMoves();
+    startTurn();
+}
+
+void Game::handle(const Event &event) {
+    if (event.type == Event::MouseButtonPressed &&
+        event.mouseButton.button == Mouse::Left && humanToMove())
+    {
+        if (boardGui.click(event.mouseButton.x, event.mouseButton.y,
+                           board)) {
+            endTurn();
+        }
+    }
+    if (event.type == Event::KeyPressed) {
+        if (event.key.code == Keyboard::Space && humanToMove()) {
+            board.move(PASSING_MOVE);
+            endTurn();
+        } else if (event.key.code == Keyboard::Return && ai) {
+            ai->forceMove();
+        } else if (event.key.code == Keyboard::Escape && aiThinking()) {
+            ai->cancel();
+            aiCancelled = true;
+            cout << "AI cancelled, play its move" << endl;
+        }
+    }
+    // The window lost what it showed
+    if (event.type == Event::Resized || event.type == Event::GainedFocus) {
+        redraw = true;
+    }
+    if (event.type == Event::Closed) {
+        closeWindow();
+    }
+}
+
+// Draws only when the board changed. Waiting for the human blocks on the
+// next event; while the AI thinks, its move is polled every WINDOW_POLL_MS.
 void Game::play() {
     Event event;
     board.exploreMoves();
+    startTurn();
 
     while (window.isOpen())
     {
-        while (window.pollEvent(event))
-        {
-            if (event.type == Event::MouseButtonPressed)
-            {
-                if (event.mouseButton.button == Mouse::Left)
-                {
-                    boardGui.click(event.mouseButton.x, event.mouseButton.y,
-                        board);
-                }
-            }
-            if (event.type == Event::KeyPressed) {
-                if (event.key.code == Keyboard::Space) {
-                    board.move(PASSING_MOVE);
-                }
-            }
-            if      (event.type == Event::MouseButtonPressed ||
-                     event.key.code == Keyboard::Space) {
-                if (board.isGameOver()) {
-                    closeWindow();
-                }
-                board.exploreMoves();
-            }
-            if (event.type == Event::Closed) {
-                closeWindow();
-            }
+        if (!aiThinking() && !redraw && window.waitEvent(event)) {
+            handle(event);
+        }
+        while (window.isOpen() && window.pollEvent(event)) {
+            handle(event);
+        }
+
+        // The AI's move, as soon as it is ready
+        int move;
+        if (ai && ai->poll(move)) {
+            board.move(move);
+            endTurn();
         }
 
-        window.clear(Color::White);
-        boardGui.draw(window);
-        window.draw(divider);
-        window.display();
+        if (redraw && window.isOpen()) {
+            window.clear(Color::White);
+            boardGui.draw(window);
+            window.draw(divider);
+            window.display();
+            redraw = false;
+        } else if (aiThinking()) {
+            sleep(milliseconds(WINDOW_POLL_MS));
+        }
     }
 }
 
@@ -70,91 +125,103 @@ void Game::closeWindow() {
     return;
 }
 
-BoardGui::BoardGui(int edgeSize) {
+// Two triangles
+static void appendRect(VertexArray &vertices, float x, float y, float width,
+                       float height, const Color &color) {
+    Vector2f corners[6] = {{x, y}, {x + width, y}, {x, y + height},
+                           {x + width, y}, {x + width, y + height},
+                           {x, y + height}};
+    for (auto &corner: corners) {
+        vertices.append(Vertex(corner, color));
+    }
+}
+
+static Color discColor(char cell) {
+    return cell == BLACK ? Color::Black
+         : cell == WHITE ? Color::White : Color::Transparent;
+}
+
+BoardGui::BoardGui(int edgeSize)
+        : discs(Triangles, edgeSize * edgeSize * DISC_VERTICES) {
     this->edgeSize = edgeSize;
     nCells = edgeSize * edgeSize;
 
     base.offset = BOARD_OFFSET;
+    base.step = 0;
+    base.vertices.setPrimitiveType(Triangles);
+    // Nothing shown yet, the first update() paints every disc
+    shown = vector<char>(nCells, 0);
+}
 
-    base.background.setFillColor(Color(0, 160, 12));
-    base.background.setOutlineColor(Color::Black);
-    base.background.setOutlineThickness(BOARD_THICKNESS);
-
-    base.grid = vector<RectangleShape> (2 * (edgeSize - 1),
-                                        RectangleShape(Vector2f(0, 0)));
-    for (auto &line: base.grid) {
-        line.setFillColor(Color::Black);
-    }
-
-    discs = vector<CircleShape> (nCells, CircleShape(0));
-    // Set discs to be invisible in the beginning ...
-    for (int i = 0, size = discs.size(); i < size; ++i) {
-        discs[i].setFillColor(Color::Transparent);
+void BoardGui::paint(int cell, char disc) {
+    Color color = discColor(disc);
+    for (int i = cell * DISC_VERTICES; i < (cell + 1) * DISC_VERTICES; ++i) {
+        discs[i].color = color;
     }
-    // ... except for the initial
-    int start = (edgeSize + 1) * (edgeSize / 2 - 1);
-    discs[start].setFillColor(Color::White);
-    discs[start + 1].setFillColor(Color::Black);
-    discs[start + edgeSize].setFillColor(Color::White);
-    discs[start + edgeSize + 1].setFillColor(Color::Black);
+    shown[cell] = disc;
 }
 
-void BoardGui::update(vector<char> &cells) {
+bool BoardGui::update(const vector<char> &cells) {
+    bool changed = false;
     for (int i = 0, e = cells.size(); i < e; ++i) {
-        if (cells[i] == BLACK) {
-            discs[i].setFillColor(Color::Black);
-        } else if (cells[i] == WHITE) {
-            discs[i].setFillColor(Color::White);
-        } else {
-            discs[i].setFillColor(Color::Transparent);
+        if (cells[i] != shown[i]) {
+            paint(i, cells[i]);
+            changed = true;
         }
     }
+    return changed;
 }
 
 void BoardGui::place(int height) {
     // For grid lines
     int size = height - 2 * base.offset;
     base.step = size / (float)edgeSize; // presume the board is always square
-    base.background.setPosition(base.offset, base.offset);
-    base.background.setSize(Vector2f(size, size));
 
+    base.vertices.clear();
+    appendRect(base.vertices, base.offset - BOARD_THICKNESS,
+               base.offset - BOARD_THICKNESS, size + 2 * BOARD_THICKNESS,
+               size + 2 * BOARD_THICKNESS, Color::Black);
+    appendRect(base.vertices, base.offset, base.offset, size, size,
+               Color(0, 160, 12));
     for (int i = 0; i < edgeSize - 1; ++i) {
-        // Vertical
-        base.grid[i].setSize(Vector2f(BOARD_THICKNESS, size));
-        base.grid[i].setPosition(base.offset + (i + 1) * base.step, base.offset);
-        // Horizontal
-        base.grid[i + edgeSize - 1].setSize(Vector2f(size, BOARD_THICKNESS));
-        base.grid[i + edgeSize - 1].setPosition(base.offset,
-            base.offset + (i + 1) * base.step);
-        base.grid[i + edgeSize - 1].setRotation(0);
+        float line = base.offset + (i + 1) * base.step;
+        appendRect(base.vertices, line, base.offset, BOARD_THICKNESS, size,
+                   Color::Black); // vertical
+        appendRect(base.vertices, base.offset, line, size, BOARD_THICKNESS,
+                   Color::Black); // horizontal
     }
 
+    // Fans around the centre of each cell, colours are kept
     float radius = DISC_RADIUS_RATIO * base.step;
-    float shift = (base.step - 2 * radius) / 2;
-    for (auto &disc: discs) {
-        disc.setRadius(radius);
-    }
-    for (int i = 0, size = discs.size(); i < size; ++i) {
-        discs[i].setPosition(base.offset + (i % edgeSize) * base.step + shift,
-                             base.offset + (i / edgeSize) * base.step + shift);
+    for (int cell = 0; cell < nCells; ++cell) {
+        Vector2f centre(base.offset + (cell % edgeSize + 0.5f) * base.step,
+                        base.offset + (cell / edgeSize + 0.5f) * base.step);
+        for (int k = 0; k < DISC_SEGMENTS; ++k) {
+            float from = 2 * M_PI * k / DISC_SEGMENTS;
+            float to = 2 * M_PI * (k + 1) / DISC_SEGMENTS;
+            Vertex *triangle = &discs[cell * DISC_VERTICES + 3 * k];
+            triangle[0].position = centre;
+            triangle[1].position = centre + radius * Vector2f(cos(from),
+                                                              sin(from));
+            triangle[2].position = centre + radius * Vector2f(cos(to),
+                                                              sin(to));
+        }
     }
 }
-void BoardGui::click(int x, int y, OthelloBoard &board) {
+
+// The caller's update() shows the move
+bool BoardGui::click(int x, int y, OthelloBoard &board) {
     int cellNumber = (y - base.offset) / base.step * edgeSize +
                      (x - base.offset) / base.step;
     // board.print();
-    if (board.getMoves().find(cellNumber) != board.getMoves().end()) {
+    if (board.getMoves().contains(cellNumber)) {
         board.move(cellNumber);
-        update(board.getCells());
+        return true;
     }
+    return false;
 }
 
 void BoardGui::draw(RenderWindow &window) {
-    window.draw(base.background);
-    for (int i = 0; i < 2 * (edgeSize - 1); ++i) {
-        window.draw(base.grid[i]);
-    }
-    for (auto &disc: discs) {
-        window.draw(disc);
-    }
+    window.draw(base.vertices);
+    window.draw(discs);
 }
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "MCTS.hpp"
+
+using namespace std;
+using namespace chrono;
+
+NodeArena::NodeArena(int capacity) : nodes(new MCTSNode[capacity]) {
+    this->capacity = capacity;
+    used = 0;
+}
+
+int NodeArena::allocate(int count) {
+    int first = used.load(memory_order_relaxed);
+    do {
+        if (count > capacity - first) {
+            return -1;
+        }
+    } while (!used.compare_exchange_weak(first, first + count,
+                                         memory_order_relaxed));
+    return first;
+}
+
+MCTS::MCTS(int maxPlayouts, int timeBudgetMs, int threads, unsigned seed,
+           int nodes) : arena(max(nodes, 1)) {
+    this->maxPlayouts = maxPlayouts;
+    setTimeBudget(timeBudgetMs);
+    this->threads = max(threads, 1);
+    this->seed = seed;
+    stop = nullptr;
+    playoutsStarted = 0;
+    playouts = 0;
+    elapsed = 0;
+    bestWinRate = 0;
+}
+
+void MCTS::setTimeBudget(int timeBudgetMs) {
+    this->timeBudgetMs = timeBudgetMs;
+    if (maxPlayouts <= 0 && timeBudgetMs <= 0) {
+        maxPlayouts = MCTS_DEFAULT_PLAYOUTS;
+    }
+}
+
+double MCTS::getPlayoutsPerSecond() const {
+    return elapsed > 0 ? playouts / elapsed : 0;
+}
+
+void MCTS::printStats(ostream &out) const {
+    out << playouts << " playouts on " << threads << " threads in " << elapsed
+        << " s (" << (long long)getPlayoutsPerSecond() << " playouts/s), "
+        << getTreeSize() << " nodes, win rate " << bestWinRate << endl;
+}
+
+// Creates the children of node for the position on board: its moves, a
+// pass if it has none, nothing if the game is over
+void MCTS::expand(OthelloBoard &board, int node) {
+    board.exploreMoves();
+    const MoveList &moves = board.getMoves();
+    int nChildren = moves.size();
+    bool pass = false;
+    if (nChildren == 0) {
+        board.changePlayer();
+        pass = board.countMoves() > 0;
+        board.changePlayer();
+        nChildren = pass ? 1 : 0;
+    }
+
+    int first = nChildren > 0 ? arena.allocate(nChildren) : 0;
+    if (first < 0) { // the arena is full, no thread tries again
+        arena[node].firstChild.store(MCTS_FULL, memory_order_release);
+        return;
+    }
+    for (int i = 0; i < nChildren; ++i) {
+        MCTSNode &child = arena[first + i];
+        child.visits = 0;
+        child.score = 0;
+        child.firstChild = MCTS_LEAF;
+        child.move = pass ? PASSING_MOVE : moves[i].to;
+        child.nChildren = 0;
+    }
+    arena[node].nChildren = nChildren;
+    arena[node].firstChild.store(first, memory_order_release);
+}
+
+// Child of an expanded node with the best upper confidence bound,
+// unvisited children first
+int MCTS::select(int node) {
+    MCTSNode &parent = arena[node];
+    int first = parent.firstChild.load(memory_order_acquire);
+    double logVisits = log((double)max(parent.visits.load(), 1));
+    int best = first;
+    double bestValue = -1;
+    for (int i = first; i < first + parent.nChildren; ++i) {
+        int visits = arena[i].visits.load(memory_order_relaxed);
+        if (visits == 0) {
+            return i;
+        }
+        double value = arena[i].score.load(memory_order_relaxed) /
+                       (2.0 * visits) +
+                       MCTS_EXPLORATION * sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Plays random moves to the end of the game and takes them back, returns
+// the final score()
+int MCTS::rollout(OthelloBoard &board, minstd_rand &rng) {
+    int plies = 0;
+    bool passed = false;
+    while (true) {
+        board.exploreMoves();
+        int move = board.random(rng());
+        if (move == PASSING_MOVE) {
+            if (passed) { // neither side can move
+                break;
+            }
+            passed = true;
+        } else {
+            passed = false;
+        }
+        board.makeMove(move);
+        ++plies;
+    }
+    int score = board.score();
+    for (; plies > 0; --plies) {
+        board.unmakeMove();
+    }
+    return score;
+}
+
+void MCTS::runWorker(const OthelloBoard &root, unsigned workerSeed) {
+    OthelloBoard board = root;
+    minstd_rand rng(workerSeed);
+    vector<int> path;
+    vector<char> movers; // player who played each node of path
+
+    while (true) {
+        if ((timeBudgetMs > 0 && steady_clock::now() >= deadline) ||
+            (stop && stop->load(memory_order_relaxed))) {
+            break;
+        }
+        int started = playoutsStarted++;
+        if (maxPlayouts > 0 && started >= maxPlayouts) {
+            break;
+        }
+
+        // Walk down to a leaf, adding a virtual loss to every node on the
+        // way, and expand it if no other thread does
+        path.assign(1, 0);
+        movers.assign(1, EMPTY); // the root has no move
+        arena[0].visits += MCTS_VIRTUAL_LOSS;
+        int node = 0;
+        while (true) {
+            MCTSNode &current = arena[node];
+            int first = current.firstChild.load(memory_order_acquire);
+            if (first == MCTS_LEAF) {
+                int expected = MCTS_LEAF;
+                if (current.firstChild.compare_exchange_strong(
+                        expected, MCTS_EXPANDING)) {
+                    expand(board, node);
+                }
+                break;
+            }
+            if (first == MCTS_EXPANDING || first == MCTS_FULL ||
+                current.nChildren == 0) {
+                break;
+            }
+            node = select(node);
+            arena[node].visits += MCTS_VIRTUAL_LOSS;
+            movers.push_back(board.getPlayer());
+            path.push_back(node);
+            board.makeMove(arena[node].move);
+        }
+
+        int score = rollout(board, rng);
+
+        // The virtual losses become the visits, the result is added to
+        // them; the root only counts visits
+        for (int i = path.size() - 1; i >= 0; --i) {
+            MCTSNode &visited = arena[path[i]];
+            if (MCTS_VIRTUAL_LOSS != 1) {
+                visited.visits += 1 - MCTS_VIRTUAL_LOSS;
+            }
+            if (i == 0) {
+                break;
+            }
+            int mine = movers[i] == BLACK ? score : -score;
+            visited.score += mine > 0 ? 2 : mine == 0 ? 1 : 0;
+            board.unmakeMove();
+        }
+    }
+}
+
+int MCTS::bestMove(const OthelloBoard &board) {
+    steady_clock::time_point startTime = steady_clock::now();
+    deadline = startTime + milliseconds(timeBudgetMs);
+    playoutsStarted = 0;
+    playouts = 0;
+    elapsed = 0;
+    bestWinRate = 0;
+
+    OthelloBoard root = board;
+    root.exploreMoves();
+    if (root.getMoves().empty()) {
+        return PASSING_MOVE;
+    }
+
+    arena.reset();
+    MCTSNode &top = arena[arena.allocate(1)];
+    top.visits = 0;
+    top.score = 0;
+    top.firstChild = MCTS_LEAF;
+    top.move = PASSING_MOVE;
+    top.nChildren = 0;
+
+    vector<thread> workers;
+    for (int i = 1; i < threads; ++i) {
+        workers.emplace_back(&MCTS::runWorker, this, cref(root),
+                             seed * threads + i);
+    }
+    runWorker(root, seed * threads);
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    int started = playoutsStarted;
+    playouts = maxPlayouts > 0 ? min(started, maxPlayouts) : started;
+    elapsed = duration<double>(steady_clock::now() - startTime).count();
+
+    // Stopped before the first playout, any move will do
+    if (top.nChildren == 0) {
+        return root.getMoves()[0].to;
+    }
+
+    // The most visited child is the most trusted one
+    int first = top.firstChild, best = first;
+    for (int i = first; i < first + top.nChildren; ++i) {
+        if (arena[i].visits > arena[best].visits) {
+            best = i;
+        }
+    }
+    bestWinRate = arena[best].score /
+                  (2.0 * max((int)arena[best].visits, 1));
+    return arena[best].move;
+}
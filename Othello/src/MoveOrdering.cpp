@@ -0,0 +1,95 @@
+#include <algorithm>
+#include "Board.hpp"
+#include "MoveOrdering.hpp"
+
+using namespace std;
+
+MoveOrdering::MoveOrdering(unsigned heuristics) {
+    this->heuristics = heuristics;
+    nCells = 0;
+    fill(&killers[0][0], &killers[0][0] + ORDER_MAX_PLY *
+         ORDER_KILLERS_PER_PLY, PASSING_MOVE);
+}
+
+// Corners are never flipped back; X- and C-squares hand them to the
+// opponent while the corner is empty
+void MoveOrdering::resize(int edgeSize) {
+    nCells = edgeSize * edgeSize;
+    history.assign(2 * nCells, 0);
+    squares.assign(nCells, 0);
+    int last = edgeSize - 1;
+    for (int row = 0; row < edgeSize; ++row) {
+        for (int column = 0; column < edgeSize; ++column) {
+            bool rowEdge = row == 0 || row == last;
+            bool columnEdge = column == 0 || column == last;
+            bool rowNext = row == 1 || row == last - 1;
+            bool columnNext = column == 1 || column == last - 1;
+            int16_t &value = squares[row * edgeSize + column];
+            if (rowEdge && columnEdge) {
+                value = ORDER_CORNER;
+            } else if (rowNext && columnNext) {
+                value = ORDER_X_SQUARE;
+            } else if ((rowEdge && columnNext) || (rowNext && columnEdge)) {
+                value = ORDER_C_SQUARE;
+            } else if (rowEdge || columnEdge) {
+                value = ORDER_EDGE;
+            }
+        }
+    }
+}
+
+void MoveOrdering::prepare(int edgeSize) {
+    if (edgeSize * edgeSize != nCells) {
+        resize(edgeSize);
+    }
+    fill(&killers[0][0], &killers[0][0] + ORDER_MAX_PLY *
+         ORDER_KILLERS_PER_PLY, PASSING_MOVE);
+    for (int &value: history) {
+        value /= 2;
+    }
+}
+
+void MoveOrdering::order(MoveList &moves, int ttMove, int ply, char player) {
+    if (heuristics == ORDER_NONE) {
+        return;
+    }
+    const int *side = history.data() + (player == WHITE ? nCells : 0);
+    const int16_t *killed = ply < ORDER_MAX_PLY ? killers[ply] : nullptr;
+    for (Move &move: moves) {
+        int to = move.to, key = 0;
+        if (heuristics & ORDER_STATIC) {
+            key += squares[to] + move.score; // the flips
+        }
+        if (heuristics & ORDER_HISTORY) {
+            key += side[to] >> ORDER_HISTORY_SHIFT;
+        }
+        for (int i = 0; (heuristics & ORDER_KILLERS) && killed &&
+                        i < ORDER_KILLERS_PER_PLY; ++i) {
+            if (killed[i] == to) {
+                key += ORDER_KILLER_BONUS - i;
+                break;
+            }
+        }
+        if ((heuristics & ORDER_TT) && to == ttMove) {
+            key = ORDER_TT_KEY;
+        }
+        move.score = key;
+    }
+    moves.sort();
+}
+
+void MoveOrdering::cutoff(int to, int ply, int depth, char player) {
+    if (ply < ORDER_MAX_PLY && killers[ply][0] != to) {
+        for (int i = ORDER_KILLERS_PER_PLY - 1; i > 0; --i) {
+            killers[ply][i] = killers[ply][i - 1];
+        }
+        killers[ply][0] = to;
+    }
+    int &value = history[(player == WHITE ? nCells : 0) + to];
+    value += depth * depth;
+    if (value > ORDER_HISTORY_MAX) {
+        for (int &other: history) {
+            other /= 2;
+        }
+    }
+}
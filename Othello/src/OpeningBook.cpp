@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "OpeningBook.hpp"
+
+using namespace std;
+
+OpeningBook::OpeningBook() {
+    mappedSize = 0;
+    mapping = nullptr;
+    edgeSize = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+OpeningBook::~OpeningBook() {
+    unload();
+}
+
+void OpeningBook::unload() {
+    if (mapping) {
+        munmap(mapping, mappedSize);
+    }
+    mappedSize = 0;
+    mapping = nullptr;
+    edgeSize = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+bool OpeningBook::loadDefault() {
+    const char *path = getenv("OTHELLO_BOOK");
+    if (path) {
+        return load(path);
+    }
+    return access(BOOK_DEFAULT_PATH, R_OK) == 0 && load(BOOK_DEFAULT_PATH);
+}
+
+bool OpeningBook::load(const string &path) {
+    unload();
+
+    // The mapping outlives the descriptor
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        cerr << "Cannot open the opening book " << path << endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    mappedSize = st.st_size;
+    if (mappedSize < sizeof(BookHeader)) {
+        cerr << path << " is not an opening book" << endl;
+        close(fd);
+        unload();
+        return false;
+    }
+    mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        cerr << "Cannot map the opening book " << path << endl;
+        unload();
+        return false;
+    }
+
+    const BookHeader *header = (const BookHeader *)mapping;
+    if (memcmp(header->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 ||
+        header->version != BOOK_VERSION ||
+        mappedSize != sizeof(BookHeader) +
+                      header->count * sizeof(BookEntry)) {
+        cerr << path << " is not an opening book of version " << BOOK_VERSION
+             << endl;
+        unload();
+        return false;
+    }
+    edgeSize = header->edgeSize;
+    count = header->count;
+    entries = (const BookEntry *)(header + 1);
+    return true;
+}
+
+const BookEntry *OpeningBook::find(uint64_t hash) const {
+    const BookEntry *end = entries + count;
+    const BookEntry *entry = lower_bound(
+        entries, end, hash,
+        [](const BookEntry &e, uint64_t h) {return e.hash < h;});
+    return entry != end && entry->hash == hash ? entry : nullptr;
+}
+
+int OpeningBook::lookup(const OthelloBoard &board) const {
+    if (!loaded() || board.getEdgeSize() != edgeSize) {
+        return PASSING_MOVE;
+    }
+    const BookEntry *entry = find(board.getHash());
+    return entry ? entry->move : PASSING_MOVE;
+}
+
+bool OpeningBook::write(const string &path, int edgeSize,
+                        vector<BookEntry> entries) {
+    sort(entries.begin(), entries.end(),
+         [](const BookEntry &a, const BookEntry &b) {return a.hash < b.hash;});
+
+    BookHeader header = {};
+    memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.version = BOOK_VERSION;
+    header.edgeSize = edgeSize;
+    header.count = entries.size();
+
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write((const char *)&header, sizeof(header));
+    out.write((const char *)entries.data(),
+              entries.size() * sizeof(BookEntry));
+    if (!out) {
+        cerr << "Cannot write the opening book " << path << endl;
+        return false;
+    }
+    return true;
+}
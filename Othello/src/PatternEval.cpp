@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unistd.h>
+#include "PatternEval.hpp"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PATTERN_HAVE_AVX2
+#endif
+
+using namespace std;
+
+#define PATTERN_MOBILITY_WEIGHT 10
+#define PATTERN_AVX2_LANES 8 // the corners and edges, one vector
+
+// Kind of each lane and the rotation of the board it reads
+static const int LANE_KINDS[PATTERN_LANES] = {CORNER, CORNER, CORNER, CORNER,
+                                            EDGE, EDGE, EDGE, EDGE,
+                                            DIAGONAL, DIAGONAL};
+static const int LANE_TURNS[PATTERN_LANES] = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1};
+
+// Hand-made value of a cell by its distance to the closest corner
+static const int SQUARES[4][4] = {{100, -20, 10, 5},
+                                  {-20, -50, -2, -2},
+                                  {10, -2, -1, -1},
+                                  {5, -2, -1, -1}};
+
+static int cellCount(int kind) {
+    return kind == CORNER ? 9 : 8;
+}
+
+// Cell k of a kind of pattern at the top left corner, the edges and
+// diagonals reach to the opposite corner
+static void canonicalCell(int kind, int k, int edgeSize, int &row, int &col) {
+    int far = k < 4 ? k : edgeSize - 8 + k;
+    if (kind == CORNER) {
+        row = k / 3;
+        col = k % 3;
+    } else if (kind == EDGE) {
+        row = 0;
+        col = far;
+    } else {
+        row = col = far;
+    }
+}
+
+PatternEval::PatternEval() {
+#ifdef PATTERN_HAVE_AVX2
+    avx2 = __builtin_cpu_supports("avx2");
+#else
+    avx2 = false;
+#endif
+    setDefaults();
+    buildLanes();
+}
+
+int PatternEval::size(PatternKind kind) {
+    int size = 1;
+    for (int k = 0; k < cellCount(kind); ++k) {
+        size *= 3;
+    }
+    return size;
+}
+
+const char *PatternEval::name(PatternKind kind) {
+    static const char *NAMES[N_PATTERN_KINDS] = {"corner", "edge",
+                                                 "diagonal"};
+    return NAMES[kind];
+}
+
+void PatternEval::setAvx2(bool on) {
+#ifdef PATTERN_HAVE_AVX2
+    avx2 = on && __builtin_cpu_supports("avx2");
+#else
+    avx2 = false;
+#endif
+}
+
+// The weight of a configuration is the sum of the values of its cells,
+// own cells counting for and opponent's against. Next to an occupied
+// corner the cells are no longer dangerous and count 0 instead.
+void PatternEval::setDefaults() {
+    for (int kind = 0; kind < N_PATTERN_KINDS; ++kind) {
+        int nCells = cellCount(kind);
+        weights[kind].assign(size((PatternKind)kind), 0);
+        for (int index = 0; index < (int)weights[kind].size(); ++index) {
+            int states[PATTERN_MAX_CELLS];
+            for (int k = 0, rest = index; k < nCells; ++k, rest /= 3) {
+                states[k] = rest % 3;
+            }
+            int value = 0;
+            for (int k = 0; k < nCells; ++k) {
+                if (states[k] == 0) {
+                    continue;
+                }
+                int row, col;
+                canonicalCell(kind, k, 8, row, col);
+                int dr = min(row, 7 - row), dc = min(col, 7 - col);
+                int cell = SQUARES[min(dr, 3)][min(dc, 3)];
+                // The corner of the 3x3 is cell 0, those of the lines 0
+                // and 7
+                int corner = kind == CORNER || k < 4 ? 0 : nCells - 1;
+                if (cell < 0 && states[corner] != 0) {
+                    cell = 0;
+                }
+                value += states[k] == 1 ? cell : -cell;
+            }
+            weights[kind][index] = value;
+        }
+    }
+    mobility.resize(PATTERN_MOBILITY_MAX + 1);
+    for (int moves = 0; moves <= PATTERN_MOBILITY_MAX; ++moves) {
+        mobility[moves] = PATTERN_MOBILITY_WEIGHT * moves;
+    }
+    buildTable();
+}
+
+bool PatternEval::loadDefault() {
+    const char *path = getenv("OTHELLO_WEIGHTS");
+    if (path) {
+        return load(path);
+    }
+    return access(PATTERN_DEFAULT_PATH, R_OK) == 0 &&
+           load(PATTERN_DEFAULT_PATH);
+}
+
+bool PatternEval::load(const string &path) {
+    ifstream in(path);
+    if (!in) {
+        cerr << "Cannot open the weight file " << path << endl;
+        return false;
+    }
+    vector<int32_t> loaded[N_PATTERN_KINDS];
+    vector<int32_t> loadedMobility;
+    string section;
+    while (in >> section) {
+        if (section[0] == '#') { // comment line
+            in.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        int count = -1;
+        in >> count;
+        vector<int32_t> *target = nullptr;
+        int expected = 0;
+        for (int kind = 0; kind < N_PATTERN_KINDS; ++kind) {
+            if (section == name((PatternKind)kind)) {
+                target = &loaded[kind];
+                expected = size((PatternKind)kind);
+            }
+        }
+        if (section == "mobility") {
+            target = &loadedMobility;
+            expected = PATTERN_MOBILITY_MAX + 1;
+        }
+        if (!target || count != expected) {
+            cerr << path << ": expected " << expected << " weights for "
+                 << section << ", got " << count << endl;
+            return false;
+        }
+        target->resize(count);
+        for (int i = 0; i < count; ++i) {
+            in >> (*target)[i];
+        }
+        if (!in) {
+            cerr << path << ": " << section << " is cut short" << endl;
+            return false;
+        }
+    }
+    if (!in.eof()) {
+        cerr << path << " is not a weight file" << endl;
+        return false;
+    }
+
+    for (int kind = 0; kind < N_PATTERN_KINDS; ++kind) {
+        if (!loaded[kind].empty()) {
+            weights[kind].swap(loaded[kind]);
+        }
+    }
+    if (!loadedMobility.empty()) {
+        mobility.swap(loadedMobility);
+    }
+    buildTable();
+    return true;
+}
+
+bool PatternEval::save(const string &path) const {
+    ofstream out(path);
+    out << "# Othello pattern weights, see PatternEval" << endl;
+    for (int kind = 0; kind < N_PATTERN_KINDS; ++kind) {
+        out << name((PatternKind)kind) << ' ' << weights[kind].size();
+        for (size_t i = 0; i < weights[kind].size(); ++i) {
+            out << (i % 16 == 0 ? '\n' : ' ') << weights[kind][i];
+        }
+        out << endl;
+    }
+    out << "mobility " << mobility.size();
+    for (size_t i = 0; i < mobility.size(); ++i) {
+        out << (i % 16 == 0 ? '\n' : ' ') << mobility[i];
+    }
+    out << endl;
+    if (!out) {
+        cerr << "Cannot write the weight file " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+// Rotates every instance of its kind into place on each board size
+void PatternEval::buildLanes() {
+    lanes.resize(MAXIMUM_OTHELLO_BOARD_SIZE + 1);
+    for (int edgeSize = PATTERN_MIN_EDGE;
+         edgeSize <= MAXIMUM_OTHELLO_BOARD_SIZE; ++edgeSize) {
+        PatternLanes &layout = lanes[edgeSize];
+        int nCells = edgeSize * edgeSize;
+        for (int lane = 0; lane < PATTERN_LANES; ++lane) {
+            for (int k = 0; k < PATTERN_MAX_CELLS; ++k) {
+                layout.cells[k][lane] = nCells;
+                if (k >= cellCount(LANE_KINDS[lane])) {
+                    continue;
+                }
+                int row, col;
+                canonicalCell(LANE_KINDS[lane], k, edgeSize, row, col);
+                for (int turn = 0; turn < LANE_TURNS[lane]; ++turn) {
+                    int r = row;
+                    row = col;
+                    col = edgeSize - 1 - r;
+                }
+                layout.cells[k][lane] = row * edgeSize + col;
+            }
+        }
+    }
+}
+
+void PatternEval::buildTable() {
+    int kindOffsets[N_PATTERN_KINDS];
+    table.clear();
+    for (int kind = 0; kind < N_PATTERN_KINDS; ++kind) {
+        kindOffsets[kind] = table.size();
+        table.insert(table.end(), weights[kind].begin(), weights[kind].end());
+    }
+    for (int lane = 0; lane < PATTERN_LANES; ++lane) {
+        offsets[lane] = kindOffsets[LANE_KINDS[lane]];
+    }
+}
+
+// Indices are built from the last cell down, index = 3 * index + state
+int PatternEval::sumLane(const PatternLanes &layout, const int32_t *states,
+                         int lane) const {
+    int index = 0;
+    for (int k = PATTERN_MAX_CELLS - 1; k >= 0; --k) {
+        index = 3 * index + states[layout.cells[k][lane]];
+    }
+    return table[offsets[lane] + index];
+}
+
+int PatternEval::sumScalar(const PatternLanes &layout,
+                           const int32_t *states) const {
+    int total = 0;
+    for (int lane = 0; lane < PATTERN_LANES; ++lane) {
+        total += sumLane(layout, states, lane);
+    }
+    return total;
+}
+
+// Gathers are slow enough for the last, mostly empty, vector to cost more
+// than its 2 lanes one by one
+#ifdef PATTERN_HAVE_AVX2
+__attribute__((target("avx2")))
+int PatternEval::sumAvx2(const PatternLanes &layout,
+                         const int32_t *states) const {
+    __m256i index = _mm256_setzero_si256();
+    for (int k = PATTERN_MAX_CELLS - 1; k >= 0; --k) {
+        __m256i cells = _mm256_loadu_si256((const __m256i *)layout.cells[k]);
+        __m256i state = _mm256_i32gather_epi32(states, cells, 4);
+        index = _mm256_add_epi32(
+            _mm256_add_epi32(index, _mm256_add_epi32(index, index)), state);
+    }
+    index = _mm256_add_epi32(index,
+                             _mm256_loadu_si256((const __m256i *)offsets));
+    __m256i total = _mm256_i32gather_epi32(table.data(), index, 4);
+
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(total),
+                                _mm256_extracti128_si256(total, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    int result = _mm_cvtsi128_si32(sum);
+    for (int lane = PATTERN_AVX2_LANES; lane < PATTERN_LANES; ++lane) {
+        result += sumLane(layout, states, lane);
+    }
+    return result;
+}
+#else
+int PatternEval::sumAvx2(const PatternLanes &layout,
+                         const int32_t *states) const {
+    return sumScalar(layout, states);
+}
+#endif
+
+int PatternEval::evaluate(OthelloBoard &board) const {
+    const vector<char> &cells = board.getCells();
+    int nCells = cells.size();
+    char player = board.getPlayer();
+
+    // 0 for empty, 1 for own, 2 for opponent's, then the empty cell nCells
+    int32_t states[MAXIMUM_OTHELLO_BOARD_SIZE * MAXIMUM_OTHELLO_BOARD_SIZE + 1];
+    char opponent = player == BLACK ? WHITE : BLACK;
+    for (int pos = 0; pos < nCells; ++pos) { // branchless, vectorizes
+        states[pos] = (cells[pos] == player) + 2 * (cells[pos] == opponent);
+    }
+    states[nCells] = 0;
+
+    const PatternLanes &layout = lanes[board.getEdgeSize()];
+    int total = avx2 ? sumAvx2(layout, states) : sumScalar(layout, states);
+    int moves = min(board.getMoves().size(), PATTERN_MOBILITY_MAX);
+    return total + mobility[moves];
+}
@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <thread>
+#include "Search.hpp"
+
+using namespace std;
+using namespace chrono;
+
+#define CORNER_WEIGHT 20
+#define MOBILITY_WEIGHT 2
+
+Search::Search(int maxDepth, int timeBudgetMs, TranspositionTable *table,
+               int threads, const PatternEval *eval) {
+    this->maxDepth = maxDepth;
+    this->timeBudgetMs = timeBudgetMs;
+    this->table = table;
+    this->eval = eval;
+    this->threads = max(threads, 1);
+    threadId = 0;
+    stop = nullptr;
+    nodes = 0;
+    cutoffs = firstCutoffs = 0;
+    counters = SearchCounters{0, 0, 0};
+    completedDepth = 0;
+    bestScore = 0;
+    elapsed = 0;
+    aborted = false;
+    rootPly = 0;
+}
+
+double Search::getNodesPerSecond() const {
+    return elapsed > 0 ? nodes / elapsed : 0;
+}
+
+double Search::getFirstCutoffRate() const {
+    return cutoffs > 0 ? firstCutoffs / (double)cutoffs : 0;
+}
+
+void Search::printStats(ostream &out) const {
+    out << "depth " << completedDepth << ", score " << bestScore << ", "
+        << nodes << " nodes on " << threads << " threads in " << elapsed
+        << " s ("
+        << (long long)getNodesPerSecond() << " nodes/s), "
+        << (int)(100 * getFirstCutoffRate()) << "% of " << cutoffs
+        << " cutoffs on the first move" << endl;
+}
+
+bool Search::outOfTime() {
+    if (nodes % SEARCH_CHECK_INTERVAL == 0 &&
+        ((timeBudgetMs > 0 && steady_clock::now() >= deadline) ||
+         (stop && stop->load(memory_order_relaxed)))) {
+        aborted = true;
+    }
+    return aborted;
+}
+
+// Static evaluation from the point of view of the player to move,
+// expects board.exploreMoves() to have been called
+int Search::evaluate(OthelloBoard &board) const {
+    if (eval && PatternEval::supports(board.getEdgeSize())) {
+        return eval->evaluate(board);
+    }
+
+    const vector<char> &cells = board.getCells();
+    int edgeSize = board.getEdgeSize(), last = edgeSize * edgeSize - 1;
+    char player = board.getPlayer();
+
+    int corners = 0;
+    for (int corner: {0, edgeSize - 1, last - edgeSize + 1, last}) {
+        if (cells[corner] == player) {
+            ++corners;
+        } else if (cells[corner] != EMPTY) {
+            --corners;
+        }
+    }
+    int discs = player == BLACK ? board.score() : -board.score();
+    int mobility = board.getMoves().size();
+
+    return discs + CORNER_WEIGHT * corners + MOBILITY_WEIGHT * mobility;
+}
+
+int Search::negamax(OthelloBoard &board, int depth, int alpha, int beta,
+                    bool passed) {
+    ++nodes;
+    if (outOfTime()) {
+        return 0;
+    }
+
+    board.exploreMoves();
+    if (board.getMoves().empty()) {
+        if (passed) { // neither side can move
+            int discs = board.getPlayer() == BLACK ? board.score()
+                                                   : -board.score();
+            return discs > 0 ? SEARCH_WIN + discs :
+                   discs < 0 ? -SEARCH_WIN + discs : 0;
+        }
+        board.makeMove(PASSING_MOVE);
+        int value = -negamax(board, depth, -beta, -alpha, true);
+        board.unmakeMove();
+        return value;
+    }
+    if (depth == 0) {
+        STATS(++counters.evaluations);
+        return evaluate(board);
+    }
+
+    // Cut off on a deep enough stored bound, otherwise try its move first
+    int ttMove = PASSING_MOVE, alphaOrig = alpha;
+    uint64_t key = board.getHash();
+    TTEntry entry;
+    if (table && table->probe(key, entry, threadId)) {
+        ttMove = entry.move;
+        if (entry.depth >= depth) {
+            if (entry.bound == BOUND_EXACT) {
+                return entry.score;
+            } else if (entry.bound == BOUND_LOWER) {
+                alpha = max(alpha, entry.score);
+            } else if (entry.bound == BOUND_UPPER) {
+                beta = min(beta, entry.score);
+            }
+            if (alpha >= beta) {
+                return entry.score;
+            }
+        }
+    }
+
+    // Children overwrite the board's list, search the copy of this ply
+    int ply = board.getPly() - rootPly;
+    if (ply >= (int)plyMoves.size()) {
+        plyMoves.resize(ply + 1);
+    }
+    MoveList &moves = plyMoves[ply];
+    moves = board.getMoves();
+    char player = board.getPlayer();
+    ordering.order(moves, ttMove, ply, player);
+    STATS(++counters.expanded);
+    STATS(counters.movesGenerated += moves.size());
+
+    int best = -SEARCH_INF, bestMove = PASSING_MOVE;
+    for (int i = 0, e = moves.size(); i < e; ++i) {
+        int to = moves[i].to;
+        int value = searchMove(board, to, depth, alpha, beta);
+        if (aborted) {
+            break;
+        }
+        if (value > best) {
+            best = value;
+            bestMove = to;
+            if (value > alpha) {
+                alpha = value;
+                if (alpha >= beta) {
+                    ++cutoffs;
+                    firstCutoffs += i == 0;
+                    ordering.cutoff(to, ply, depth, player);
+                    break;
+                }
+            }
+        }
+    }
+    if (aborted) {
+        return 0;
+    }
+
+    if (table) {
+        Bound bound = best <= alphaOrig ? BOUND_UPPER :
+                      best >= beta ? BOUND_LOWER : BOUND_EXACT;
+        table->store(key, best, bestMove, depth, bound, threadId);
+    }
+    return best;
+}
+
+// Value of playing to on board for the player to move
+int Search::searchMove(OthelloBoard &board, int to, int depth, int alpha,
+                       int beta) {
+    board.makeMove(to);
+    int value = -negamax(board, depth - 1, -beta, -alpha, false);
+    board.unmakeMove();
+    return value;
+}
+
+// Searches rootMoves in order and moves the best one to the front
+int Search::searchRoot(OthelloBoard &board, int depth, vector<int> &rootMoves) {
+    int alpha = -SEARCH_INF, best = 0;
+    for (int i = 0, e = rootMoves.size(); i < e; ++i) {
+        int value = searchMove(board, rootMoves[i], depth, alpha, SEARCH_INF);
+        if (aborted) {
+            break;
+        }
+        if (value > alpha) {
+            alpha = value;
+            best = i;
+        }
+    }
+    // A partial iteration searched the previous best move first, so a move
+    // it found better is safe to play
+    rotate(rootMoves.begin(), rootMoves.begin() + best,
+           rootMoves.begin() + best + 1);
+    if (table && !aborted) {
+        table->store(board.getHash(), alpha, rootMoves[0], depth, BOUND_EXACT,
+                     threadId);
+    }
+    return alpha;
+}
+
+void Search::iterate(OthelloBoard &root, vector<int> &rootMoves,
+                     int firstDepth) {
+    for (int depth = firstDepth; depth <= maxDepth; ++depth) {
+        int score = searchRoot(root, depth, rootMoves);
+        if (aborted) {
+            break;
+        }
+        bestScore = score;
+        completedDepth = depth;
+    }
+}
+
+// Statistics and ordering for a search from root
+void Search::prepare(const OthelloBoard &root) {
+    aborted = false;
+    nodes = 0;
+    cutoffs = firstCutoffs = 0;
+    counters = SearchCounters{0, 0, 0};
+    rootPly = root.getPly();
+    if (plyMoves.empty()) {
+        plyMoves.resize(1);
+    }
+    ordering.prepare(root.getEdgeSize());
+}
+
+// Helpers start one ply deeper every other thread and rotate the root moves
+// so that they do not all walk the tree in the main thread's order
+void Search::runHelper(const OthelloBoard &board, const vector<int> &moves) {
+    OthelloBoard root = board;
+    prepare(root);
+    vector<int> rootMoves = moves;
+    rotate(rootMoves.begin(), rootMoves.begin() + threadId % rootMoves.size(),
+           rootMoves.end());
+    iterate(root, rootMoves, 1 + threadId % 2);
+}
+
+int Search::bestMove(const OthelloBoard &board) {
+    startTime = steady_clock::now();
+    deadline = startTime + milliseconds(timeBudgetMs);
+    completedDepth = 0;
+    bestScore = 0;
+
+    OthelloBoard root = board;
+    root.exploreMoves();
+    prepare(root);
+    // Until the first iteration sorts them, by the static order
+    MoveList &moves = plyMoves[0];
+    moves = root.getMoves();
+    ordering.order(moves, PASSING_MOVE, 0, root.getPlayer());
+    vector<int> rootMoves;
+    for (const Move &move: moves) {
+        rootMoves.push_back(move.to);
+    }
+    if (rootMoves.empty()) {
+        elapsed = 0;
+        return PASSING_MOVE;
+    }
+
+    // The main thread reorders rootMoves while the helpers copy theirs
+    const vector<int> helperMoves = rootMoves;
+    atomic<bool> stopHelpers(false);
+    vector<Search> helpers;
+    vector<thread> workers;
+    if (threads > 1 && table) {
+        table->setThreads(threads);
+        helpers.reserve(threads - 1);
+        for (int i = 1; i < threads; ++i) {
+            helpers.emplace_back(maxDepth, 0, table, 1, eval);
+            helpers.back().threadId = i;
+            helpers.back().stop = &stopHelpers;
+            helpers.back().setOrdering(ordering.getHeuristics());
+        }
+        for (auto &helper: helpers) {
+            workers.emplace_back(&Search::runHelper, &helper, cref(board),
+                                 cref(helperMoves));
+        }
+    }
+
+    iterate(root, rootMoves, 1);
+
+    stopHelpers = true;
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    for (auto &helper: helpers) {
+        nodes += helper.nodes;
+        cutoffs += helper.cutoffs;
+        firstCutoffs += helper.firstCutoffs;
+        counters.expanded += helper.counters.expanded;
+        counters.movesGenerated += helper.counters.movesGenerated;
+        counters.evaluations += helper.counters.evaluations;
+    }
+
+    elapsed = duration<double>(steady_clock::now() - startTime).count();
+    return rootMoves[0];
+}
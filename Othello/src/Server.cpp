@@ -0,0 +1,357 @@
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Server.hpp"
+
+using namespace std;
+using namespace chrono;
+
+// The agents of a pool thread, one for each agent name and board size
+struct Engine
+{
+    OthelloBoard board;
+    Agent agent;
+    long long lastUsed; // search count of the thread when it last searched
+
+    Engine(const AgentSpec &spec, int edgeSize, unsigned seed,
+           const OpeningBook *book, const PatternEval *eval)
+        : board(edgeSize), agent(spec, board, false, seed, book, eval),
+          lastUsed(0) {}
+};
+
+void Client::reply(const string &line) {
+    lock_guard<mutex> lock(outMutex);
+    if (gone) {
+        return;
+    }
+    string data = line + "\n";
+    for (size_t sent = 0; sent < data.size(); ) {
+        ssize_t n = write(out, data.data() + sent, data.size() - sent);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            gone = true; // the client will not read the rest either
+            return;
+        }
+        sent += n;
+    }
+}
+
+void Client::searchQueued() {
+    lock_guard<mutex> lock(outMutex);
+    ++searches;
+}
+
+void Client::searchDone() {
+    lock_guard<mutex> lock(outMutex);
+    --searches;
+    answered.notify_all();
+}
+
+void Client::waitSearches() {
+    unique_lock<mutex> lock(outMutex);
+    answered.wait(lock, [this] {return searches == 0;});
+}
+
+Session::Session(const string &id, const string &agentName,
+                 const AgentSpec &spec, int edgeSize, int budgetMs,
+                 const shared_ptr<Client> &client)
+        : id(id), agentName(agentName), spec(spec), board(edgeSize),
+          budgetMs(budgetMs), usedMs(0), busy(false), closed(false),
+          client(client) {
+    board.exploreMoves();
+}
+
+// An equal share of what is left for each of the agent's remaining moves
+int Session::moveTimeMs() const {
+    if (budgetMs <= 0) {
+        return spec.moveTimeMs;
+    }
+    long long left = budgetMs - usedMs;
+    int movesLeft = board.getEmptyCount() / 2 + 1;
+    return max((long long)SERVER_MIN_MOVE_MS, left / movesLeft);
+}
+
+Server::Server(int edgeSize, int threads, const OpeningBook *book,
+               const PatternEval *eval)
+        : edgeSize(edgeSize), book(book), eval(eval), quitting(false) {
+    nSessions = 0;
+    searches = 0;
+    for (int i = 0; i < max(threads, 1); ++i) {
+        pool.emplace_back(&Server::runWorker, this, i);
+    }
+}
+
+Server::~Server() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        quitting = true;
+        wake.notify_all();
+    }
+    for (auto &th: pool) {
+        th.join();
+    }
+}
+
+void Server::runWorker(unsigned id) {
+    map<string, unique_ptr<Engine>> engines;
+    long long searched = 0;
+    unique_lock<mutex> lock(queueMutex);
+    while (true) {
+        wake.wait(lock, [this] {return quitting || !queue.empty();});
+        if (queue.empty()) { // quitting once the queue is drained
+            return;
+        }
+        shared_ptr<Session> session = queue.front();
+        queue.pop_front();
+        lock.unlock();
+
+        string position;
+        int moveMs;
+        bool closed;
+        {
+            lock_guard<mutex> guard(sessionMutex);
+            position = session->board.getPosition();
+            moveMs = session->moveTimeMs();
+            closed = session->closed;
+        }
+        if (closed) { // no one would read the move
+            session->client->searchDone();
+            lock.lock();
+            continue;
+        }
+        int size = OthelloBoard::edgeSizeOf(position);
+        string key = session->agentName + "@" + to_string(size);
+        // A new agent replaces the one left unused the longest
+        if (!engines.count(key) && engines.size() >= SERVER_MAX_ENGINES) {
+            auto oldest = engines.begin();
+            for (auto it = engines.begin(); it != engines.end(); ++it) {
+                if (it->second->lastUsed < oldest->second->lastUsed) {
+                    oldest = it;
+                }
+            }
+            engines.erase(oldest);
+        }
+        unique_ptr<Engine> &engine = engines[key];
+        if (!engine) {
+            engine.reset(new Engine(session->spec, size, id, book, eval));
+        }
+        engine->lastUsed = ++searched;
+        engine->board.setPosition(position);
+        engine->board.exploreMoves();
+        engine->agent.setMoveTime(moveMs);
+        auto start = steady_clock::now();
+        int move = engine->agent.getMove();
+        long long ms = duration_cast<milliseconds>(steady_clock::now() -
+                                                   start).count();
+        // Engines outlive the games they play, nothing reports their moves
+        engine->agent.clearStats();
+        ++searches;
+
+        string reply;
+        {
+            lock_guard<mutex> guard(sessionMutex);
+            session->usedMs += ms;
+            session->busy = false;
+            if (!session->closed) {
+                session->board.move(move);
+                session->board.exploreMoves();
+                reply = "move " + session->id + " " + to_string(move);
+            }
+        }
+        if (!reply.empty()) {
+            session->client->reply(reply);
+        }
+        session->client->searchDone();
+        lock.lock();
+    }
+}
+
+// The reply to line, empty if it comes later
+string Server::handle(const string &line, const shared_ptr<Client> &client,
+                      map<string, shared_ptr<Session>> &sessions) {
+    istringstream in(line);
+    vector<string> words;
+    for (string word; in >> word; ) {
+        words.push_back(word);
+    }
+    const string &command = words[0];
+    if (command == "stats") {
+        lock_guard<mutex> lock(queueMutex);
+        return "stats " + to_string(nSessions) + " " +
+               to_string(queue.size()) + " " + to_string(searches);
+    }
+    if (words.size() < 2) {
+        return "error - missing game id";
+    }
+    const string &id = words[1];
+
+    if (command == "new") {
+        AgentSpec spec;
+        int size = words.size() > 3 ? atoi(words[3].c_str()) : edgeSize;
+        int budgetMs = words.size() > 4 ? atoi(words[4].c_str()) : 0;
+        if (sessions.count(id)) {
+            return "error " + id + " game exists";
+        }
+        if (words.size() < 3 || !AgentSpec::parse(words[2], spec) ||
+            spec.strategy == HUMAN) {
+            return "error " + id + " unknown agent";
+        }
+        if (size < MINIMUM_OTHELLO_BOARD_SIZE ||
+            size > MAXIMUM_OTHELLO_BOARD_SIZE || budgetMs < 0) {
+            return "error " + id + " invalid board size or time";
+        }
+        sessions[id] = make_shared<Session>(id, words[2], spec, size,
+                                            budgetMs, client);
+        ++nSessions;
+        return "ok " + id;
+    }
+
+    auto found = sessions.find(id);
+    if (found == sessions.end()) {
+        return "error " + id + " unknown game";
+    }
+    shared_ptr<Session> session = found->second;
+    lock_guard<mutex> lock(sessionMutex);
+    OthelloBoard &board = session->board;
+    string over = "over " + id + " " + to_string(board.score());
+
+    if (command == "show") {
+        return "board " + id + " " + board.getPosition();
+    }
+    if (command == "close") {
+        session->closed = true;
+        sessions.erase(found);
+        --nSessions;
+        return "ok " + id;
+    }
+    if (command != "play" && command != "go") {
+        return "error " + id + " unknown command";
+    }
+    if (session->busy) {
+        return "error " + id + " busy";
+    }
+    if (board.isGameOver()) {
+        return over;
+    }
+    if (command == "go") {
+        session->busy = true;
+        client->searchQueued();
+        lock_guard<mutex> queueLock(queueMutex);
+        queue.push_back(session);
+        wake.notify_one();
+        return "";
+    }
+
+    // play
+    MoveList &moves = board.getMoves();
+    int cell = words.size() > 2 ? atoi(words[2].c_str()) : PASSING_MOVE - 1;
+    if (!moves.contains(cell) && (cell != PASSING_MOVE || !moves.empty())) {
+        return "error " + id + " illegal move";
+    }
+    board.move(cell);
+    board.exploreMoves();
+    return board.isGameOver() ? "over " + id + " " + to_string(board.score())
+                              : "ok " + id;
+}
+
+void Server::serve(int in, int out) {
+    shared_ptr<Client> client = make_shared<Client>(out);
+    map<string, shared_ptr<Session>> sessions;
+    string buffer;
+    char chunk[SERVER_READ_BYTES];
+    bool quit = false;
+    while (true) {
+        size_t end = buffer.find('\n');
+        if (end == string::npos) {
+            ssize_t n = read(in, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            buffer.append(chunk, n);
+            continue;
+        }
+        string line = buffer.substr(0, end);
+        buffer.erase(0, end + 1);
+        if (line.find_first_not_of(" \t\r") == string::npos) {
+            continue;
+        }
+        string command;
+        istringstream(line) >> command;
+        if (command == "quit") {
+            quit = true;
+            break;
+        }
+        string reply = handle(line, client, sessions);
+        if (!reply.empty()) {
+            client->reply(reply);
+        }
+    }
+
+    // A client that only closed its input still reads the moves it asked
+    // for; after quit, the searches of its games answer no one
+    if (!quit) {
+        client->waitSearches();
+    }
+    {
+        lock_guard<mutex> lock(sessionMutex);
+        for (auto &entry: sessions) {
+            entry.second->closed = true;
+        }
+        nSessions -= sessions.size();
+    }
+    lock_guard<mutex> lock(client->outMutex);
+    client->gone = true;
+}
+
+bool Server::listen(const string &path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << "Socket path too long: " << path << endl;
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+    unlink(path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (sockaddr *)&address, sizeof(address)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0) {
+        cerr << "Cannot listen on " << path << ": " << strerror(errno)
+             << endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    // A client gone while it is answered must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    while (true) {
+        int connection = accept(fd, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            cerr << "Cannot accept on " << path << ": " << strerror(errno)
+                 << endl;
+            close(fd);
+            return false;
+        }
+        // The server outlives its clients, they are not joined
+        thread([this, connection] {
+            serve(connection, connection);
+            close(connection);
+        }).detach();
+    }
+}
@@ -0,0 +1,89 @@
+#include <fstream>
+#include <iomanip>
+#include "Stats.hpp"
+
+using namespace std;
+
+#define CSV_HEADER "empties,player,move,phase,book_seconds,think_seconds," \
+                   "nodes,expanded,moves_generated,evaluations,tt_probes," \
+                   "tt_hits,depth,threads,branching"
+
+void GameStats::writeJSON(ostream &out) const {
+    out << "{\"moves\": [";
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const MoveReport &m = moves[i];
+        out << (i ? ",\n  " : "\n  ") << "{\"empties\": " << m.empties
+            << ", \"player\": \"" << m.player << "\", \"move\": " << m.move
+            << ", \"phase\": \"" << m.phase << "\", \"book_seconds\": "
+            << m.bookSeconds << ", \"think_seconds\": " << m.thinkSeconds
+            << ", \"nodes\": " << m.nodes << ", \"expanded\": " << m.expanded
+            << ", \"moves_generated\": " << m.movesGenerated
+            << ", \"evaluations\": " << m.evaluations << ", \"tt_probes\": "
+            << m.ttProbes << ", \"tt_hits\": " << m.ttHits << ", \"depth\": "
+            << m.depth << ", \"threads\": " << m.threads
+            << ", \"branching\": " << m.branching() << "}";
+    }
+    out << (moves.empty() ? "]}" : "\n]}") << endl;
+}
+
+void GameStats::writeCSV(ostream &out) const {
+    out << CSV_HEADER << endl;
+    for (const MoveReport &m: moves) {
+        out << m.empties << ',' << m.player << ',' << m.move << ','
+            << m.phase << ',' << m.bookSeconds << ',' << m.thinkSeconds << ','
+            << m.nodes << ',' << m.expanded << ',' << m.movesGenerated << ','
+            << m.evaluations << ',' << m.ttProbes << ',' << m.ttHits << ','
+            << m.depth << ',' << m.threads << ',' << m.branching() << endl;
+    }
+}
+
+bool GameStats::save(const string &path) const {
+    ofstream out(path);
+    if (!out) {
+        cerr << "Cannot write " << path << endl;
+        return false;
+    }
+    bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4,
+                                                ".csv") == 0;
+    if (csv) {
+        writeCSV(out);
+    } else {
+        writeJSON(out);
+    }
+    return bool(out);
+}
+
+void GameStats::print(ostream &out) const {
+    MoveReport total = {};
+    for (const MoveReport &m: moves) {
+        total.bookSeconds += m.bookSeconds;
+        total.thinkSeconds += m.thinkSeconds;
+        total.nodes += m.nodes;
+        total.expanded += m.expanded;
+        total.movesGenerated += m.movesGenerated;
+        total.evaluations += m.evaluations;
+        total.ttProbes += m.ttProbes;
+        total.ttHits += m.ttHits;
+    }
+    out << setw(8) << "empties" << setw(9) << "phase" << setw(6) << "move"
+        << setw(10) << "seconds" << setw(12) << "nodes" << setw(12)
+        << "evals" << setw(8) << "depth" << setw(11) << "branching"
+        << setw(9) << "tt hits" << endl;
+    for (const MoveReport &m: moves) {
+        out << setw(8) << m.empties << setw(9) << m.phase << setw(6)
+            << m.move << setw(10) << fixed << setprecision(4)
+            << m.bookSeconds + m.thinkSeconds << setw(12) << m.nodes
+            << setw(12) << m.evaluations << setw(8) << m.depth << setw(11)
+            << setprecision(2) << m.branching() << setw(8)
+            << setprecision(0)
+            << (m.ttProbes ? 100.0 * m.ttHits / m.ttProbes : 0) << "%"
+            << endl;
+    }
+    out << defaultfloat << setprecision(6);
+    out << moves.size() << " moves in " << total.bookSeconds +
+           total.thinkSeconds << " s (" << total.bookSeconds
+        << " s in the book), " << total.nodes << " nodes, "
+        << total.evaluations << " evaluations, " << total.ttHits << " of "
+        << total.ttProbes << " table probes hit, branching factor "
+        << total.branching() << endl;
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Tournament.hpp"
+
+using namespace std;
+using namespace chrono;
+
+Tournament::Tournament(int edgeSize, const string &firstName,
+                       const AgentSpec &first, const string &secondName,
+                       const AgentSpec &second, int nGames, int threads,
+                       const OpeningBook *book, const PatternEval *eval)
+        : edgeSize(edgeSize), nGames(nGames), threads(max(threads, 1)),
+          firstName(firstName), secondName(secondName), first(first),
+          second(second), book(book), eval(eval) {}
+
+int Tournament::playGame(const AgentSpec &black, const AgentSpec &white,
+                         unsigned seed) const {
+    OthelloBoard board(edgeSize);
+    Agent blackAgent(black, board, false, 2 * seed, book, eval);
+    Agent whiteAgent(white, board, false, 2 * seed + 1, book, eval);
+
+    while (!board.isGameOver()) {
+        board.exploreMoves();
+        Agent &agent = board.getPlayer() == BLACK ? blackAgent : whiteAgent;
+        board.move(agent.getMove());
+    }
+    return board.score();
+}
+
+TournamentResult Tournament::run() const {
+    TournamentResult result = {0, 0, 0, 0, 0, 0};
+    mutex resultMutex;
+    atomic<int> nextGame(0);
+    auto start = steady_clock::now();
+
+    auto worker = [&]() {
+        TournamentResult local = {0, 0, 0, 0, 0, 0};
+        for (int game = nextGame++; game < nGames; game = nextGame++) {
+            // The first agent plays black in even games
+            bool firstIsBlack = game % 2 == 0;
+            int score = firstIsBlack ? playGame(first, second, game)
+                                     : -playGame(second, first, game);
+            ++local.games;
+            local.discs += score;
+            if (score > 0) {
+                ++local.wins;
+            } else if (score < 0) {
+                ++local.losses;
+            } else {
+                ++local.draws;
+            }
+        }
+        lock_guard<mutex> lock(resultMutex);
+        result.games += local.games;
+        result.wins += local.wins;
+        result.draws += local.draws;
+        result.losses += local.losses;
+        result.discs += local.discs;
+    };
+
+    vector<thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (auto &th: pool) {
+        th.join();
+    }
+
+    result.seconds = duration<double>(steady_clock::now() - start).count();
+    return result;
+}
+
+void Tournament::printResult(const TournamentResult &result,
+                             ostream &out) const {
+    double points = result.wins + 0.5 * result.draws;
+    out << firstName << " vs " << secondName << " on " << edgeSize << "x"
+        << edgeSize << ", " << result.games << " games on " << threads
+        << " threads" << endl;
+    out << "  +" << result.wins << " =" << result.draws << " -"
+        << result.losses << " (" << 100 * points / max(result.games, 1)
+        << "%), average disc differential "
+        << (double)result.discs / max(result.games, 1) << endl;
+    out << "  " << result.seconds << " s, "
+        << result.games / max(result.seconds, 1e-9) << " games/s" << endl;
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include "TranspositionTable.hpp"
+
+using namespace std;
+
+#define TT_FILL_SAMPLE 1024 // buckets
+
+static inline uint64_t pack(int score, int move, int depth, Bound bound) {
+    return (uint64_t)(uint32_t)score |
+           (uint64_t)(uint16_t)move << 32 |
+           (uint64_t)(uint8_t)depth << 48 |
+           (uint64_t)bound << 56;
+}
+
+static inline TTEntry unpack(uint64_t key, uint64_t data) {
+    return TTEntry{key, (int32_t)(uint32_t)data, (int16_t)(data >> 32),
+                   (int8_t)(data >> 48), (Bound)(data >> 56)};
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    // Round down to a power of two number of buckets
+    size_t nBuckets = 1;
+    while (nBuckets * 2 * sizeof(TTBucket) <= megabytes * 1024 * 1024) {
+        nBuckets *= 2;
+    }
+    buckets = vector<TTBucket>(nBuckets);
+    mask = nBuckets - 1;
+    setThreads(1);
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (auto &bucket: buckets) {
+        for (auto &slot: bucket.slots) {
+            slot.check.store(0, memory_order_relaxed);
+            slot.data.store(0, memory_order_relaxed); // BOUND_NONE
+        }
+    }
+    for (auto &counter: counters) {
+        counter = TTCounters{0, 0, 0, 0};
+    }
+}
+
+void TranspositionTable::setThreads(int threads) {
+    if ((int)counters.size() < threads) {
+        counters.resize(threads, TTCounters{0, 0, 0, 0});
+    }
+}
+
+long long TranspositionTable::sum(long long TTCounters::*counter) const {
+    long long total = 0;
+    for (auto &thread: counters) {
+        total += thread.*counter;
+    }
+    return total;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry &entry, int thread) {
+    STATS(TTCounters &count = counters[thread]);
+    STATS(++count.probes);
+    TTBucket &bucket = buckets[key & mask];
+    for (auto &slot: bucket.slots) {
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        uint64_t check = slot.check.load(memory_order_relaxed);
+        if ((check ^ data) == key && (Bound)(data >> 56) != BOUND_NONE) {
+            STATS(++count.hits);
+            entry = unpack(key, data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int score, int move, int depth,
+                               Bound bound, int thread) {
+    STATS(TTCounters &count = counters[thread]);
+    STATS(++count.stores);
+    TTBucket &bucket = buckets[key & mask];
+
+    // Same position first, then an empty slot, then the shallowest entry
+    TTSlot *victim = &bucket.slots[0];
+    TTEntry victimEntry = {};
+    for (auto &slot: bucket.slots) {
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        TTEntry candidate = unpack(slot.check.load(memory_order_relaxed) ^ data,
+                                   data);
+        if (&slot == &bucket.slots[0]) {
+            victimEntry = candidate;
+        }
+        if (candidate.key == key || candidate.bound == BOUND_NONE) {
+            victim = &slot;
+            victimEntry = candidate;
+            break;
+        }
+        if (candidate.depth < victimEntry.depth) {
+            victim = &slot;
+            victimEntry = candidate;
+        }
+    }
+
+    if (victimEntry.bound != BOUND_NONE && victimEntry.key != key) {
+        STATS(++count.collisions);
+    }
+    uint64_t data = pack(score, move, min(depth, 127), bound);
+    victim->data.store(data, memory_order_relaxed);
+    victim->check.store(key ^ data, memory_order_relaxed);
+}
+
+double TranspositionTable::getFill() const {
+    size_t sample = min(buckets.size(), (size_t)TT_FILL_SAMPLE), used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        for (auto &slot: buckets[i].slots) {
+            used += (Bound)(slot.data.load(memory_order_relaxed) >> 56) !=
+                    BOUND_NONE;
+        }
+    }
+    return (double)used / (sample * TT_BUCKET_SIZE);
+}
+
+void TranspositionTable::printStats(ostream &out) const {
+    out << "TT: " << getProbes() << " probes, " << getHits() << " hits ("
+        << 100 * getHitRate() << "%), " << getStores() << " stores, "
+        << getCollisions() << " collisions, " << 100 * getFill()
+        << "% full of " << getCapacity() << " entries" << endl;
+}
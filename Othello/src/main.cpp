@@ -1,8 +1,11 @@
 #include <cstdlib>
 #include <iostream>
 #include "Agent.hpp"
+#include "AsyncAgent.hpp"
 #include "Board.hpp"
 #include "Gui.hpp"
+#include "OpeningBook.hpp"
+#include "PatternEval.hpp"
 
 using namespace std;
 
@@ -41,17 +44,57 @@ void playNoGUI(OthelloBoard &board, Agent &agent1, Agent &agent2) {
     }
 
     printResult(board);    
+    // The AI's moves, for $OTHELLO_PROFILE
+    const char *path = getenv("OTHELLO_PROFILE");
+    if (path && agent1.getStats().save(path)) {
+        cout << "Move report written to " << path << endl;
+    }
 }
 
-void playGUI(OthelloBoard &board) {
-    Game game(board);
+// Two humans, or a human against an AI playing black
+void playGUI(OthelloBoard &board, const AgentSpec &spec,
+             const OpeningBook &book, const PatternEval &eval) {
+    if (spec.strategy == HUMAN) {
+        Game game(board);
+        game.play();
+        return;
+    }
+    AsyncAgent ai(spec, board.getEdgeSize(), 0, &book, &eval);
+    Game game(board, &ai, BLACK);
     game.play();
 }
 
+void printUsage() {
+    cerr << "Usage: othello BOARD_SIZE [gui [AGENT]]" << endl;
+    cerr << "       othello BOARD_SIZE console" << endl;
+    cerr << "AGENT is random, greedy[:EMPTIES], search:DEPTH[:EMPTIES] or "
+         << "mcts:PLAYOUTS[:THREADS]" << endl;
+    cerr << "EMPTIES is where perfect endgame play starts, 0 for never"
+         << endl;
+    cerr << "Greedy, search and mcts agents open from $OTHELLO_BOOK or "
+         << BOOK_DEFAULT_PATH << " if there is one" << endl;
+    cerr << "In the GUI, AGENT plays black against the mouse; Enter makes "
+         << "it move now, Escape lets the mouse play its move" << endl;
+    cerr << "Search agents evaluate with the weights of $OTHELLO_WEIGHTS or "
+         << PATTERN_DEFAULT_PATH << " if there is one" << endl;
+    cerr << "In the console, the AI's moves are reported to "
+         << "$OTHELLO_PROFILE (.json, or .csv) if it is set" << endl;
+}
+
+AgentSpec readAgent(const char *name) {
+    AgentSpec spec;
+    if (!AgentSpec::parse(name, spec) || spec.strategy == HUMAN) {
+        cerr << "Unknown agent " << name << endl;
+        printUsage();
+        exit(1);
+    }
+    return spec;
+}
+
 int readBoardSize(int argc, char const *argv[]) {
     // Check boardSize was provided at all
     if (argc == 1) {
-        cerr << "Usage: othello BOARD_SIZE" << endl;
+        printUsage();
         exit(1);
     }
 
@@ -62,20 +105,39 @@ int readBoardSize(int argc, char const *argv[]) {
         cout << ". Changing the board size to " << MINIMUM_OTHELLO_BOARD_SIZE;
         cout << endl;
         boardSize = MINIMUM_OTHELLO_BOARD_SIZE;
+    } else if (boardSize > MAXIMUM_OTHELLO_BOARD_SIZE) {
+        cout << "Got invalid board size " << boardSize;
+        cout << ". Changing the board size to " << MAXIMUM_OTHELLO_BOARD_SIZE;
+        cout << endl;
+        boardSize = MAXIMUM_OTHELLO_BOARD_SIZE;
     }
     return boardSize;
 }
 
 int main(int argc, char const *argv[]) {
-    bool GUI = true;
     int boardSize = readBoardSize(argc, argv);
+    string mode = argc > 2 ? argv[2] : "gui";
+    OpeningBook book;
+    book.loadDefault();
+    PatternEval eval;
+    eval.loadDefault();
+    if (mode != "gui" && mode != "console") {
+        printUsage();
+        exit(1);
+    }
+    bool GUI = mode == "gui";
 
     OthelloBoard board(boardSize);
-    Agent agent1(true, board);
+    Agent agent1(true, board, 0, 0, 1, &book, &eval);
     Agent agent2(false, board);
 
     if (GUI) {
-        playGUI(board);
+        AgentSpec spec;
+        AgentSpec::parse("human", spec);
+        if (argc > 3) {
+            spec = readAgent(argv[3]);
+        }
+        playGUI(board, spec, book, eval);
     } else {
         playNoGUI(board, agent1, agent2);
     }
@@ -0,0 +1,164 @@
+// Builds an opening book from self-play: the first PLIES moves of every
+// game are random, search agents play the rest, and each position keeps
+// the move with the best average result.
+// Usage: bookgen OUTPUT [GAMES] [PLIES] [EDGE_SIZE] [THREADS]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Agent.hpp"
+#include "Board.hpp"
+#include "OpeningBook.hpp"
+
+using namespace std;
+using namespace chrono;
+
+#define BOOKGEN_GAMES 2000
+#define BOOKGEN_PLIES 8
+#define BOOKGEN_EDGE_SIZE 8
+#define BOOKGEN_DEPTH 4 // of the agents finishing the games
+#define BOOKGEN_ENDGAME_EMPTIES 10
+#define BOOKGEN_MIN_GAMES 2 // a book move was played at least this often
+
+struct MoveStats
+{
+    int games;
+    long long discs; // sum of the final differentials for the mover
+};
+
+typedef unordered_map<uint64_t, unordered_map<int, MoveStats>> BookStats;
+
+// Book positions of one game, the hash and move of each of its first plies
+struct GameRecord
+{
+    vector<pair<uint64_t, int>> plies;
+    vector<char> movers;
+    int score;
+};
+
+// Plays one game from start on board, agent finishes it
+GameRecord playGame(OthelloBoard &board, Agent &agent, const string &start,
+                    int bookPlies, unsigned seed) {
+    GameRecord record;
+    board.setPosition(start);
+    minstd_rand rng(seed);
+
+    for (int ply = 0; !board.isGameOver(); ++ply) {
+        board.exploreMoves();
+        int move = PASSING_MOVE;
+        if (ply < bookPlies) {
+            MoveList &moves = board.getMoves();
+            if (!moves.empty()) {
+                move = moves[uniform_int_distribution<int>(
+                    0, moves.size() - 1)(rng)].to;
+            }
+            record.plies.push_back({board.getHash(), move});
+            record.movers.push_back(board.getPlayer());
+        } else {
+            move = agent.getMove();
+        }
+        board.move(move);
+    }
+    record.score = board.score();
+    return record;
+}
+
+vector<BookEntry> bookEntries(const BookStats &stats) {
+    vector<BookEntry> entries;
+    for (const auto &position: stats) {
+        BookEntry best = {position.first, PASSING_MOVE, 0, 0};
+        double bestAverage = 0;
+        for (const auto &move: position.second) {
+            const MoveStats &s = move.second;
+            double average = (double)s.discs / s.games;
+            if (s.games < BOOKGEN_MIN_GAMES || move.first == PASSING_MOVE) {
+                continue;
+            }
+            if (best.games == 0 || average > bestAverage ||
+                (average == bestAverage && (uint32_t)s.games > best.games)) {
+                best.move = move.first;
+                best.score = (int16_t)average;
+                best.games = s.games;
+                bestAverage = average;
+            }
+        }
+        if (best.games > 0) {
+            entries.push_back(best);
+        }
+    }
+    return entries;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: bookgen OUTPUT [GAMES] [PLIES] [EDGE_SIZE] [THREADS]"
+             << endl;
+        exit(1);
+    }
+    string path = argv[1];
+    int nGames = argc > 2 ? atoi(argv[2]) : BOOKGEN_GAMES;
+    int bookPlies = argc > 3 ? atoi(argv[3]) : BOOKGEN_PLIES;
+    int edgeSize = argc > 4 ? atoi(argv[4]) : BOOKGEN_EDGE_SIZE;
+    int threads = argc > 5 ? atoi(argv[5]) : thread::hardware_concurrency();
+    threads = max(threads, 1);
+
+    auto start = steady_clock::now();
+    BookStats stats;
+    mutex statsMutex;
+    atomic<int> nextGame(0);
+    // Every thread plays on one board with one agent, which keeps their
+    // transposition table from game to game
+    auto worker = [&]() {
+        OthelloBoard board(edgeSize);
+        string startPosition = board.getPosition();
+        AgentSpec spec;
+        AgentSpec::parse("search:" + to_string(BOOKGEN_DEPTH) + ":" +
+                         to_string(BOOKGEN_ENDGAME_EMPTIES), spec);
+        Agent agent(spec, board);
+        for (int game = nextGame++; game < nGames; game = nextGame++) {
+            GameRecord record = playGame(board, agent, startPosition,
+                                         bookPlies, game);
+            lock_guard<mutex> lock(statsMutex);
+            for (size_t i = 0; i < record.plies.size(); ++i) {
+                int discs = record.movers[i] == BLACK ? record.score
+                                                      : -record.score;
+                MoveStats &s = stats[record.plies[i].first]
+                                    [record.plies[i].second];
+                ++s.games;
+                s.discs += discs;
+            }
+        }
+    };
+    vector<thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (auto &th: pool) {
+        th.join();
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    vector<BookEntry> entries = bookEntries(stats);
+    if (!OpeningBook::write(path, edgeSize, entries)) {
+        exit(1);
+    }
+    cout << nGames << " games in " << seconds << " s, " << stats.size()
+         << " positions, " << entries.size() << " book moves" << endl;
+
+    // Loading only maps the file, whatever its size
+    start = steady_clock::now();
+    OpeningBook book;
+    if (!book.load(path)) {
+        exit(1);
+    }
+    double loadSeconds = duration<double>(steady_clock::now() - start).count();
+    OthelloBoard board(edgeSize);
+    cout << path << ": " << book.size() << " entries, mapped in "
+         << loadSeconds * 1e6 << " us, start position plays "
+         << book.lookup(board) << endl;
+    return 0;
+}
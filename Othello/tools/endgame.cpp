@@ -0,0 +1,125 @@
+// Endgame solver time and speed by the number of empty cells.
+// Usage: endgame [MAX_EMPTIES] [POSITIONS]   solves 8x8 positions with up to
+//                                            MAX_EMPTIES empty cells
+//        endgame check                       checks the solver against a
+//                                            plain minimax
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Board.hpp"
+#include "Endgame.hpp"
+
+using namespace std;
+
+#define BENCH_EDGE_SIZE 8
+#define BENCH_MIN_EMPTIES 8
+#define BENCH_MAX_EMPTIES 18
+#define BENCH_POSITIONS 8
+#define CHECK_MAX_EMPTIES 9
+#define CHECK_POSITIONS 40
+
+// Random self-play from the start until empties cells are left, false if the
+// game ended before
+bool randomPosition(OthelloBoard &board, int empties, minstd_rand &rng) {
+    while (board.getEmptyCount() > empties) {
+        if (board.isGameOver()) {
+            return false;
+        }
+        board.exploreMoves();
+        MoveList &moves = board.getMoves();
+        int move = PASSING_MOVE;
+        if (!moves.empty()) {
+            move = moves[uniform_int_distribution<int>(
+                0, moves.size() - 1)(rng)].to;
+        }
+        board.move(move);
+    }
+    return true;
+}
+
+vector<OthelloBoard> randomPositions(int edgeSize, int empties, int count,
+                                     unsigned seed) {
+    minstd_rand rng(seed);
+    vector<OthelloBoard> positions;
+    while ((int)positions.size() < count) {
+        OthelloBoard board(edgeSize);
+        if (randomPosition(board, empties, rng)) {
+            positions.push_back(board);
+        }
+    }
+    return positions;
+}
+
+// Final score() by plain minimax, the reference of the check
+int minimax(OthelloBoard &board, bool passed) {
+    board.exploreMoves();
+    MoveList moves = board.getMoves();
+    bool black = board.getPlayer() == BLACK;
+    if (moves.empty()) {
+        if (passed) {
+            return board.score();
+        }
+        board.makeMove(PASSING_MOVE);
+        int value = minimax(board, true);
+        board.unmakeMove();
+        return value;
+    }
+    int best = black ? -ENDGAME_INF : ENDGAME_INF;
+    for (const Move &move: moves) {
+        board.makeMove(move.to);
+        int value = minimax(board, false);
+        board.unmakeMove();
+        best = black ? max(best, value) : min(best, value);
+    }
+    return best;
+}
+
+int check() {
+    int failures = 0, solves = 0;
+    EndgameSolver solver(CHECK_MAX_EMPTIES);
+    for (int edgeSize: {4, 5, 6, 8, 10}) {
+        for (int empties = 0; empties <= CHECK_MAX_EMPTIES; ++empties) {
+            for (OthelloBoard &board: randomPositions(
+                     edgeSize, empties, CHECK_POSITIONS / 4, empties)) {
+                OthelloBoard copy = board;
+                int expected = minimax(copy, false);
+                int solved = solver.solve(board);
+                int move = solver.bestMove(board);
+                int moved = solver.getScore();
+                ++solves;
+                if (solved != expected || moved != expected) {
+                    ++failures;
+                    cout << "FAIL " << board.getPosition() << ": minimax "
+                         << expected << ", solve " << solved << ", move "
+                         << move << " scores " << moved << endl;
+                }
+            }
+        }
+    }
+    cout << solves << " positions, " << failures << " failures" << endl;
+    solver.printStatsByEmpties();
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc > 1 && string(argv[1]) == "check") {
+        return check();
+    }
+    int maxEmpties = argc > 1 ? atoi(argv[1]) : BENCH_MAX_EMPTIES;
+    int count = argc > 2 ? atoi(argv[2]) : BENCH_POSITIONS;
+
+    EndgameSolver solver(maxEmpties);
+    for (int empties = BENCH_MIN_EMPTIES; empties <= maxEmpties; ++empties) {
+        for (OthelloBoard &board: randomPositions(BENCH_EDGE_SIZE, empties,
+                                                  count, empties)) {
+            solver.bestMove(board);
+        }
+    }
+    cout << count << " random " << BENCH_EDGE_SIZE << "x" << BENCH_EDGE_SIZE
+         << " positions per empty count" << endl;
+    solver.printStatsByEmpties();
+    return 0;
+}
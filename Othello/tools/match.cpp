@@ -0,0 +1,95 @@
+// Headless games between two agents, reporting wins, draws, losses and
+// games per second.
+// Usage: match AGENT1 AGENT2 GAMES [EDGE_SIZE] [THREADS]   AGENT1 plays
+//                                       black in even games
+//        match check                    results add up and do not depend
+//                                       on the number of threads
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "Agent.hpp"
+#include "Board.hpp"
+#include "OpeningBook.hpp"
+#include "PatternEval.hpp"
+#include "Tournament.hpp"
+
+using namespace std;
+
+#define MATCH_EDGE_SIZE 8
+
+bool sameResult(const TournamentResult &a, const TournamentResult &b) {
+    return a.games == b.games && a.wins == b.wins && a.draws == b.draws &&
+           a.losses == b.losses && a.discs == b.discs;
+}
+
+int check() {
+    int failures = 0;
+    auto fail = [&](const string &what) {
+        ++failures;
+        cout << "FAIL " << what << endl;
+    };
+    AgentSpec greedy, random, search;
+    AgentSpec::parse("greedy:0", greedy);
+    AgentSpec::parse("random", random);
+    AgentSpec::parse("search:2:0", search);
+
+    // Seeds come from the game number, so the threads change nothing
+    Tournament one(MATCH_EDGE_SIZE, "greedy", greedy, "random", random, 20);
+    Tournament three(MATCH_EDGE_SIZE, "greedy", greedy, "random", random, 20,
+                     3);
+    TournamentResult result = one.run();
+    one.printResult(result);
+    if (result.games != 20 ||
+        result.wins + result.draws + result.losses != result.games) {
+        fail("results of 20 games do not add up");
+    }
+    if (!sameResult(result, three.run())) {
+        fail("3 threads changed the results");
+    }
+
+    // A searching agent beats a random one on a small board
+    Tournament small(6, "search", search, "random", random, 10, 2);
+    TournamentResult smallResult = small.run();
+    small.printResult(smallResult);
+    if (smallResult.wins < 6) {
+        fail("search:2 won " + to_string(smallResult.wins) +
+             " of 10 games against random");
+    }
+
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc > 1 && string(argv[1]) == "check") {
+        return check();
+    }
+    AgentSpec first, second;
+    int games = argc > 3 ? atoi(argv[3]) : 0;
+    int edgeSize = argc > 4 ? atoi(argv[4]) : MATCH_EDGE_SIZE;
+    int threads = argc > 5 ? atoi(argv[5]) : 1;
+    if (argc < 4 || !AgentSpec::parse(argv[1], first) ||
+        first.strategy == HUMAN || !AgentSpec::parse(argv[2], second) ||
+        second.strategy == HUMAN || games <= 0 ||
+        edgeSize < MINIMUM_OTHELLO_BOARD_SIZE ||
+        edgeSize > MAXIMUM_OTHELLO_BOARD_SIZE) {
+        cerr << "Usage: match AGENT1 AGENT2 GAMES [EDGE_SIZE] [THREADS]"
+             << endl;
+        cerr << "       match check" << endl;
+        cerr << "AGENT is random, greedy[:EMPTIES], search:DEPTH[:EMPTIES] "
+             << "or mcts:PLAYOUTS[:THREADS]" << endl;
+        cerr << "Greedy, search and mcts agents open from $OTHELLO_BOOK or "
+             << BOOK_DEFAULT_PATH << " and search agents evaluate with "
+             << "$OTHELLO_WEIGHTS or " << PATTERN_DEFAULT_PATH
+             << " if there are" << endl;
+        return 1;
+    }
+    OpeningBook book;
+    book.loadDefault();
+    PatternEval eval;
+    eval.loadDefault();
+    Tournament tournament(edgeSize, argv[1], first, argv[2], second, games,
+                          threads, &book, &eval);
+    tournament.printResult(tournament.run());
+    return 0;
+}
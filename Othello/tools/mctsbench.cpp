@@ -0,0 +1,48 @@
+// MCTS playouts per second by board size and thread count.
+// Usage: mctsbench [PLAYOUTS] [MAX_THREADS]
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "Board.hpp"
+#include "MCTS.hpp"
+
+using namespace std;
+
+#define BENCH_PLAYOUTS 20000
+
+int main(int argc, char const *argv[]) {
+    int playouts = argc > 1 ? atoi(argv[1]) : BENCH_PLAYOUTS;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : thread::hardware_concurrency();
+    maxThreads = max(maxThreads, 1);
+    if (playouts <= 0) {
+        cerr << "Usage: mctsbench [PLAYOUTS] [MAX_THREADS]" << endl;
+        return 1;
+    }
+
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    cout << "size threads  playouts/s  speedup   nodes" << endl;
+    for (int edgeSize: {8, 10, 12}) {
+        OthelloBoard board(edgeSize);
+        double single = 0;
+        for (int threads: threadCounts) {
+            MCTS mcts(playouts, 0, threads, 1);
+            mcts.bestMove(board);
+            double rate = mcts.getPlayoutsPerSecond();
+            if (threads == 1) {
+                single = rate;
+            }
+            cout << setw(4) << edgeSize << setw(8) << threads
+                 << setw(12) << (long long)rate << setw(9) << fixed
+                 << setprecision(2) << rate / single << setw(8)
+                 << mcts.getTreeSize() << endl;
+        }
+    }
+    return 0;
+}
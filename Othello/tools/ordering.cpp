@@ -0,0 +1,181 @@
+// Move ordering heuristics, alone and together: nodes, time and how often
+// the first move tried cuts off, at a fixed depth.
+// Usage: ordering [DEPTH] [EDGE_SIZE]   each heuristic on greedy self-play
+//                                       positions
+//        ordering check                 ordering changes nodes, never
+//                                       values
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Board.hpp"
+#include "MoveOrdering.hpp"
+#include "Search.hpp"
+#include "TranspositionTable.hpp"
+
+using namespace std;
+
+#define BENCH_DEPTH 8
+#define BENCH_EDGE_SIZE 8
+#define BENCH_PLY_STEP 4 // plies between two benchmark positions
+#define BENCH_POSITIONS 8
+#define CHECK_DEPTH 5
+
+struct Heuristics
+{
+    const char *name;
+    unsigned flags;
+};
+
+const Heuristics configurations[] = {
+    {"none", ORDER_NONE},
+    {"static", ORDER_STATIC},
+    {"tt", ORDER_TT},
+    {"killers", ORDER_KILLERS},
+    {"history", ORDER_HISTORY},
+    {"static+tt", ORDER_STATIC | ORDER_TT},
+    {"default", ORDER_DEFAULT},
+    {"all", ORDER_ALL},
+};
+
+// Positions reached by greedy self-play from the start, as in smpbench
+vector<OthelloBoard> standardPositions(int edgeSize) {
+    vector<OthelloBoard> positions;
+    OthelloBoard board(edgeSize);
+    for (int ply = 0; (int)positions.size() < BENCH_POSITIONS &&
+                      !board.isGameOver(); ++ply) {
+        board.exploreMoves();
+        if (ply % BENCH_PLY_STEP == 0) {
+            positions.push_back(board);
+        }
+        board.move(board.greedy());
+    }
+    return positions;
+}
+
+struct Totals
+{
+    long long nodes, cutoffs;
+    double firstCutoffs, seconds;
+};
+
+// Sums over positions; scores gets the value of each position
+Totals run(const vector<OthelloBoard> &positions, int depth, unsigned flags,
+           bool useTable, vector<int> &scores) {
+    Totals totals = {0, 0, 0, 0};
+    scores.clear();
+    for (const OthelloBoard &position: positions) {
+        TranspositionTable table;
+        Search search(depth, 0, useTable ? &table : nullptr);
+        search.setOrdering(flags);
+        search.bestMove(position);
+        scores.push_back(search.getBestScore());
+        totals.nodes += search.getNodes();
+        totals.cutoffs += search.getCutoffs();
+        totals.firstCutoffs += search.getFirstCutoffRate() *
+                               search.getCutoffs();
+        totals.seconds += search.getElapsed();
+    }
+    return totals;
+}
+
+int bench(int depth, int edgeSize) {
+    vector<OthelloBoard> positions = standardPositions(edgeSize);
+    vector<int> scores;
+    cout << positions.size() << " positions on " << edgeSize << "x"
+         << edgeSize << ", depth " << depth << ", with a table" << endl;
+    cout << setw(10) << "ordering" << setw(14) << "nodes" << setw(10)
+         << "seconds" << setw(16) << "first cutoffs" << endl;
+    for (const Heuristics &heuristics: configurations) {
+        Totals totals = run(positions, depth, heuristics.flags, true, scores);
+        double rate = totals.cutoffs ? totals.firstCutoffs / totals.cutoffs
+                                     : 0;
+        cout << setw(10) << heuristics.name << setw(14) << totals.nodes
+             << setw(10) << fixed << setprecision(3) << totals.seconds
+             << setw(15) << setprecision(1) << 100 * rate << "%" << endl;
+    }
+    return 0;
+}
+
+// Orders moves that flip one disc each as a search node would
+bool expectOrder(MoveOrdering &ordering, MoveList &moves, int ply,
+                 char player, const vector<int> &expected) {
+    vector<int> order;
+    for (Move &move: moves) {
+        move.score = 1;
+    }
+    ordering.order(moves, 27, ply, player);
+    for (const Move &move: moves) {
+        order.push_back(move.to);
+    }
+    if (order != expected) {
+        cout << "FAIL order ";
+        printVector(order);
+        return false;
+    }
+    return true;
+}
+
+// Without a table alpha-beta returns the same value in any order
+int check() {
+    int failures = 0;
+    for (int edgeSize: {6, 8, 10}) {
+        vector<OthelloBoard> positions = standardPositions(edgeSize);
+        vector<int> expected, scores;
+        Totals none = run(positions, CHECK_DEPTH, ORDER_NONE, false,
+                          expected);
+        for (const Heuristics &heuristics: configurations) {
+            Totals totals = run(positions, CHECK_DEPTH, heuristics.flags,
+                                false, scores);
+            if (scores != expected) {
+                cout << "FAIL " << heuristics.name << " changes values on "
+                     << edgeSize << "x" << edgeSize << endl;
+                ++failures;
+            }
+            if (heuristics.flags == ORDER_DEFAULT &&
+                (totals.nodes >= none.nodes ||
+                 totals.firstCutoffs * none.cutoffs <=
+                 none.firstCutoffs * totals.cutoffs)) {
+                cout << "FAIL ordering does not help on " << edgeSize << "x"
+                     << edgeSize << ": " << totals.nodes << " nodes against "
+                     << none.nodes << endl;
+                ++failures;
+            }
+        }
+    }
+
+    // Corners first and X-squares last; then the table's move goes first
+    // and a killer moves up a square class
+    MoveOrdering ordering(ORDER_STATIC);
+    ordering.prepare(8);
+    MoveList moves;
+    for (int to: {9, 27, 1, 0, 3}) { // X, inner, C, corner, edge
+        moves.add(to);
+    }
+    failures += !expectOrder(ordering, moves, 2, BLACK, {0, 3, 27, 1, 9});
+    ordering.setHeuristics(ORDER_ALL);
+    ordering.cutoff(9, 2, 3, BLACK);
+    failures += !expectOrder(ordering, moves, 2, BLACK, {27, 0, 3, 9, 1});
+    // No killer at ply 3, no history for white
+    failures += !expectOrder(ordering, moves, 3, WHITE, {27, 0, 3, 1, 9});
+
+    cout << failures << " failures" << endl;
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc > 1 && string(argv[1]) == "check") {
+        return check();
+    }
+    int depth = argc > 1 ? atoi(argv[1]) : BENCH_DEPTH;
+    int edgeSize = argc > 2 ? atoi(argv[2]) : BENCH_EDGE_SIZE;
+    if (depth <= 0 || edgeSize < MINIMUM_OTHELLO_BOARD_SIZE ||
+        edgeSize > MAXIMUM_OTHELLO_BOARD_SIZE) {
+        cerr << "Usage: ordering [DEPTH] [EDGE_SIZE]" << endl;
+        cerr << "       ordering check" << endl;
+        return 1;
+    }
+    return bench(depth, edgeSize);
+}
@@ -0,0 +1,177 @@
+// Pattern evaluation tool.
+// Usage: patterns bench [WEIGHTS]   nanoseconds per evaluation, scalar and
+//                                   AVX2, on random 8x8 positions
+//        patterns write WEIGHTS     writes the default weights
+//        patterns check             checks AVX2 against scalar, a save
+//                                   and load round trip and that small
+//                                   boards are left to the search
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Board.hpp"
+#include "PatternEval.hpp"
+#include "Search.hpp"
+
+using namespace std;
+using namespace chrono;
+
+#define BENCH_EDGE_SIZE 8
+#define BENCH_POSITIONS 64 // few enough to stay in cache, as in a search
+#define BENCH_ROUNDS 20000
+#define CHECK_POSITIONS 512
+#define CHECK_WEIGHTS "/tmp/patterns_check.txt"
+#define CHECK_SMALL_EDGE 6
+#define CHECK_SMALL_DEPTH 3
+
+// Positions of random games, with their moves explored
+vector<OthelloBoard> randomPositions(int edgeSize, int count, unsigned seed) {
+    minstd_rand rng(seed);
+    vector<OthelloBoard> positions;
+    OthelloBoard board(edgeSize);
+    string start = board.getPosition();
+    while ((int)positions.size() < count) {
+        if (board.isGameOver()) {
+            board.setPosition(start);
+        }
+        board.exploreMoves();
+        positions.push_back(board);
+        MoveList &moves = board.getMoves();
+        int move = PASSING_MOVE;
+        if (!moves.empty()) {
+            move = moves[uniform_int_distribution<int>(
+                0, moves.size() - 1)(rng)].to;
+        }
+        board.move(move);
+    }
+    return positions;
+}
+
+double nanosPerEval(const PatternEval &eval, vector<OthelloBoard> &positions,
+                    long long &checksum) {
+    auto start = steady_clock::now();
+    for (int round = 0; round < BENCH_ROUNDS; ++round) {
+        for (OthelloBoard &board: positions) {
+            checksum += eval.evaluate(board);
+        }
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    return seconds * 1e9 / (BENCH_ROUNDS * positions.size());
+}
+
+int bench(const char *path) {
+    PatternEval eval;
+    if (path && !eval.load(path)) {
+        return 1;
+    }
+    vector<OthelloBoard> positions = randomPositions(BENCH_EDGE_SIZE,
+                                                     BENCH_POSITIONS, 1);
+    long long checksum = 0;
+    bool avx2 = eval.usesAvx2();
+    eval.setAvx2(false);
+    cout << "scalar: " << nanosPerEval(eval, positions, checksum)
+         << " ns/eval" << endl;
+    if (avx2) {
+        eval.setAvx2(true);
+        cout << "AVX2:   " << nanosPerEval(eval, positions, checksum)
+             << " ns/eval" << endl;
+    } else {
+        cout << "AVX2:   not supported" << endl;
+    }
+    cout << "checksum " << checksum << endl;
+    return 0;
+}
+
+// Random weights, a misplaced cell or table offset then changes the value
+bool writeRandomWeights(const string &path, unsigned seed) {
+    minstd_rand rng(seed);
+    uniform_int_distribution<int> weight(-1000, 1000);
+    ofstream out(path);
+    for (int kind = 0; kind < N_PATTERN_KINDS; ++kind) {
+        int size = PatternEval::size((PatternKind)kind);
+        out << PatternEval::name((PatternKind)kind) << ' ' << size << endl;
+        for (int i = 0; i < size; ++i) {
+            out << weight(rng) << endl;
+        }
+    }
+    out << "mobility " << PATTERN_MOBILITY_MAX + 1 << endl;
+    for (int i = 0; i <= PATTERN_MOBILITY_MAX; ++i) {
+        out << weight(rng) << endl;
+    }
+    return (bool)out;
+}
+
+int check() {
+    int failures = 0, evaluations = 0;
+    PatternEval eval, reloaded;
+    if (!writeRandomWeights(CHECK_WEIGHTS, 7) || !eval.load(CHECK_WEIGHTS) ||
+        !eval.save(CHECK_WEIGHTS) || !reloaded.load(CHECK_WEIGHTS)) {
+        return 1;
+    }
+    remove(CHECK_WEIGHTS);
+
+    for (int edgeSize: {8, 9, 10, 12, 16, 17, 32}) {
+        for (OthelloBoard &board: randomPositions(edgeSize, CHECK_POSITIONS,
+                                                  edgeSize)) {
+            eval.setAvx2(false);
+            int scalar = eval.evaluate(board);
+            eval.setAvx2(true);
+            int simd = eval.evaluate(board);
+            int loaded = reloaded.evaluate(board);
+            ++evaluations;
+            if (scalar != simd || scalar != loaded) {
+                ++failures;
+                cout << "FAIL " << board.getPosition() << ": scalar "
+                     << scalar << ", AVX2 " << simd << ", reloaded "
+                     << loaded << endl;
+            }
+        }
+    }
+
+    // The patterns would overlap on 6x6, a search given them must evaluate
+    // as if it had none
+    if (PatternEval::supports(CHECK_SMALL_EDGE)) {
+        ++failures;
+        cout << "FAIL patterns on " << CHECK_SMALL_EDGE << "x"
+             << CHECK_SMALL_EDGE << endl;
+    }
+    for (OthelloBoard &board: randomPositions(CHECK_SMALL_EDGE, 16, 1)) {
+        Search patterns(CHECK_SMALL_DEPTH, 0, nullptr, 1, &eval);
+        Search plain(CHECK_SMALL_DEPTH);
+        int move = patterns.bestMove(board);
+        if (move != plain.bestMove(board) ||
+            patterns.getBestScore() != plain.getBestScore()) {
+            ++failures;
+            cout << "FAIL " << board.getPosition() << ": the patterns "
+                 << "changed the search" << endl;
+        }
+    }
+
+    cout << evaluations << " evaluations"
+         << (eval.usesAvx2() ? "" : " (no AVX2, scalar only)") << ", "
+         << failures << " failures" << endl;
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    string mode = argc > 1 ? argv[1] : "bench";
+    if (mode == "bench") {
+        return bench(argc > 2 ? argv[2] : nullptr);
+    }
+    if (mode == "write" && argc > 2) {
+        PatternEval eval;
+        return eval.save(argv[2]) ? 0 : 1;
+    }
+    if (mode == "check") {
+        return check();
+    }
+    cerr << "Usage: patterns bench [WEIGHTS]" << endl;
+    cerr << "       patterns write WEIGHTS" << endl;
+    cerr << "       patterns check" << endl;
+    return 1;
+}
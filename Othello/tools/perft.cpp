@@ -0,0 +1,260 @@
+// Leaf counts of the game tree, to catch move generation regressions.
+// A pass is a move of its own and a finished game is a leaf.
+// Usage: perft [DEPTH] [POSITION]   counts from the 8x8 start or POSITION
+//        perft check                checks every backend against known counts
+//                                   and the incremental legal moves of the
+//                                   biggest boards against a full scan
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Board.hpp"
+
+using namespace std;
+using namespace chrono;
+
+#define PERFT_DEFAULT_DEPTH 8
+#define INCREMENTAL_GAMES 20 // random games a board size
+#define PERFT_START_8X8 "......../......../......../...ox.../...xo.../......../......../........ x"
+
+struct PerftCase
+{
+    const char *position;
+    int depth;
+    long long leaves;
+};
+
+// Counts of the 8x8 start position are the published ones, the others come
+// from an independent cell-by-cell generator
+const PerftCase SUITE[] = {
+    {PERFT_START_8X8, 1, 4},
+    {PERFT_START_8X8, 2, 12},
+    {PERFT_START_8X8, 3, 56},
+    {PERFT_START_8X8, 4, 244},
+    {PERFT_START_8X8, 5, 1396},
+    {PERFT_START_8X8, 6, 8200},
+    {PERFT_START_8X8, 7, 55092},
+    {PERFT_START_8X8, 8, 390216},
+    {PERFT_START_8X8, 9, 3005288},
+    // 8x8 middle and end games, the last ones play out to the end
+    {"......../.x...o../..x.ooo./.x.oxo../..xxo.x./.oxoox../..xxxo../..x..... x",
+     5, 554097},
+    {"....xxoo/.ox.xxox/..oxxoo./x.xox.o./.xxoxxo./xxxo.xo./.xoo..ox/..xo..o. x",
+     5, 375778},
+    {"o.oxxxx./xxx.xxxx/.xox.xxx/ooooxoxx/xxoxxoxx/.xoooxxx/xxoooo.x/oooo.o.. x",
+     10, 136661},
+    {"ooooooxo/ooxoooxo/oxoxxooo/oooxxoxo/oooxxxxo/ooooooxo/ooxxxxx./ooooo... x",
+     10, 20},
+    // Other sizes, from the narrow and wide bitboards to the cell scanner
+    {"..../.ox./.xo./.... x", 14, 59980},
+    {"...../.ox../.xo../...../..... x", 9, 511250},
+    {"....../....../..ox../..xo../....../...... x", 8, 308716},
+    {".xo.../.xo.../..oxox/.xxxo./.o.oox/...oo. x", 6, 283564},
+    {"........../........../........../........../....ox..../....xo..../........../........../........../.......... x",
+     6, 8200},
+    {"............/............/...xo.ox..../....x.x...../...ooxxo..../....oxoo..../...xoox...../..xx.xox.o../.....xooo.../......xo.o../..........o./...........o x",
+     4, 116011},
+    {"................./................./................./................./................./................./................./.......ox......../.......xo......../................./................./................./................./................./................./................./................. x",
+     4, 244},
+};
+
+// Reference backend: exploreMoves() and move() on a copy per child
+long long perftCopy(OthelloBoard &board, int depth, bool passed=false) {
+    if (depth == 0) {
+        return 1;
+    }
+    board.exploreMoves();
+    MoveList &moves = board.getMoves();
+    if (moves.empty()) {
+        if (passed) { // game over
+            return 1;
+        }
+        OthelloBoard child = board;
+        child.move(PASSING_MOVE);
+        return perftCopy(child, depth - 1, true);
+    }
+    if (depth == 1) {
+        return moves.size();
+    }
+    long long leaves = 0;
+    for (const Move &move: moves) {
+        OthelloBoard child = board;
+        child.move(move.to);
+        leaves += perftCopy(child, depth - 1);
+    }
+    return leaves;
+}
+
+// exploreMoves() and makeMove()/unmakeMove() on one board, the move list
+// of a node is copied to the stack
+long long perftUndo(OthelloBoard &board, int depth, bool passed=false) {
+    if (depth == 0) {
+        return 1;
+    }
+    board.exploreMoves();
+    if (board.getMoves().empty()) {
+        if (passed) {
+            return 1;
+        }
+        board.makeMove(PASSING_MOVE);
+        long long leaves = perftUndo(board, depth - 1, true);
+        board.unmakeMove();
+        return leaves;
+    }
+    if (depth == 1) {
+        return board.getMoves().size();
+    }
+    MoveList moves = board.getMoves();
+    long long leaves = 0;
+    for (const Move &move: moves) {
+        board.makeMove(move.to);
+        leaves += perftUndo(board, depth - 1);
+        board.unmakeMove();
+    }
+    return leaves;
+}
+
+struct Backend
+{
+    const char *name;
+    long long (*perft)(OthelloBoard &board, int depth);
+};
+
+const Backend BACKENDS[] = {
+    {"copy", [](OthelloBoard &board, int depth) {
+        return perftCopy(board, depth);
+    }},
+    {"undo", [](OthelloBoard &board, int depth) {
+        return perftUndo(board, depth);
+    }},
+};
+
+// nullptr if position is malformed
+unique_ptr<OthelloBoard> loadPosition(const string &position) {
+    int edgeSize = OthelloBoard::edgeSizeOf(position);
+    if (edgeSize == 0) {
+        return nullptr;
+    }
+    auto board = make_unique<OthelloBoard>(edgeSize);
+    if (!board->setPosition(position)) {
+        return nullptr;
+    }
+    return board;
+}
+
+// Runs backend on board and returns the leaf count, seconds set to its time
+long long timed(const Backend &backend, OthelloBoard &board, int depth,
+                double &seconds) {
+    auto start = steady_clock::now();
+    long long leaves = backend.perft(board, depth);
+    seconds = duration<double>(steady_clock::now() - start).count();
+    return leaves;
+}
+
+// The moves of board, incremental on the biggest boards, are the cells
+// countFlips() finds by scanning the whole board
+bool scanMatches(OthelloBoard &board) {
+    board.exploreMoves();
+    MoveList &moves = board.getMoves();
+    int found = 0;
+    for (int to = 0; to < board.getEdgeSize() * board.getEdgeSize(); ++to) {
+        if (board.getCells()[to] != EMPTY) {
+            continue;
+        }
+        int flips = board.countFlips(to);
+        const Move *move = moves.find(to);
+        if ((move != nullptr) != (flips > 0) ||
+            (move && move->flips() != flips)) {
+            return false;
+        }
+        found += flips > 0;
+    }
+    return found == moves.size() && found == board.countMoves();
+}
+
+// Random games with move(), each position also reached again by taking
+// moves back with unmakeMove()
+int checkIncremental() {
+    int failures = 0;
+    minstd_rand rng(1);
+    for (int edgeSize: {17, 23, 32}) {
+        for (int game = 0; game < INCREMENTAL_GAMES; ++game) {
+            OthelloBoard board(edgeSize), undone(edgeSize);
+            while (!board.isGameOver()) {
+                board.exploreMoves();
+                int move = board.random(rng());
+                // A move and its undo, then the move for good
+                undone.exploreMoves();
+                undone.makeMove(undone.random(rng()));
+                undone.unmakeMove();
+                undone.makeMove(move);
+                board.move(move);
+                if (!scanMatches(board) || !scanMatches(undone)) {
+                    ++failures;
+                    cerr << "incremental: " << board.getPosition() << endl;
+                    break;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+int check() {
+    int failures = checkIncremental();
+    for (auto &backend: BACKENDS) {
+        long long total = 0;
+        double totalSeconds = 0;
+        for (auto &test: SUITE) {
+            auto board = loadPosition(test.position);
+            if (!board) {
+                cerr << "Malformed position " << test.position << endl;
+                return 1;
+            }
+            double seconds;
+            long long leaves = timed(backend, *board, test.depth, seconds);
+            total += leaves;
+            totalSeconds += seconds;
+            if (leaves != test.leaves) {
+                ++failures;
+                cerr << backend.name << ": " << test.position << " depth "
+                     << test.depth << ": " << leaves << " leaves, expected "
+                     << test.leaves << endl;
+            }
+        }
+        cout << setw(6) << backend.name << ": " << total << " leaves in "
+             << totalSeconds << " s (" << (long long)(total / totalSeconds)
+             << " leaves/s)" << endl;
+    }
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc > 1 && string(argv[1]) == "check") {
+        return check();
+    }
+
+    int depth = argc > 1 ? atoi(argv[1]) : PERFT_DEFAULT_DEPTH;
+    auto board = loadPosition(argc > 2 ? argv[2] : PERFT_START_8X8);
+    if (!board) {
+        cerr << "Malformed position " << argv[2] << endl;
+        return 1;
+    }
+    board->print();
+    // The last backend is the fastest one
+    const Backend &backend = BACKENDS[sizeof(BACKENDS) / sizeof(Backend) - 1];
+    for (int d = 1; d <= depth; ++d) {
+        double seconds;
+        long long leaves = timed(backend, *board, d, seconds);
+        cout << "perft(" << d << ") = " << setw(12) << leaves << "  "
+             << fixed << setprecision(3) << seconds << " s  "
+             << (long long)(leaves / max(seconds, 1e-9)) << " leaves/s"
+             << endl;
+    }
+    return 0;
+}
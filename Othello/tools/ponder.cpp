@@ -0,0 +1,174 @@
+// Asynchronous agents: how much pondering on the opponent's time shortens
+// the next move, and checks of their controls.
+// Usage: ponder [DEPTH] [PONDER_MS]   time to reach DEPTH after the
+//                                     opponent's move, with and without
+//                                     PONDER_MS of pondering before it
+//        ponder check                 moves, forced moves and cancels
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Agent.hpp"
+#include "AsyncAgent.hpp"
+#include "Board.hpp"
+
+using namespace std;
+using namespace chrono;
+
+#define BENCH_EDGE_SIZE 8
+#define BENCH_DEPTH 9
+#define BENCH_PONDER_MS 1000
+#define BENCH_POSITIONS 6
+#define BENCH_PLY_STEP 6 // plies between two benchmark positions
+#define CHECK_DEEP "search:60:0" // never done in time
+#define CHECK_TIMEOUT_MS 2000 // a forced or cancelled agent is this quick
+#define POLL_MS 1
+
+// Waits up to timeoutMs for the move of agent, PASSING_MOVE - 1 if none
+int waitMove(AsyncAgent &agent, int timeoutMs, double &seconds) {
+    auto start = steady_clock::now();
+    int move;
+    while (!agent.poll(move)) {
+        seconds = duration<double>(steady_clock::now() - start).count();
+        if (seconds * 1000 > timeoutMs) {
+            return PASSING_MOVE - 1;
+        }
+        this_thread::sleep_for(milliseconds(POLL_MS));
+    }
+    seconds = duration<double>(steady_clock::now() - start).count();
+    return move;
+}
+
+// Positions of greedy self-play where the opponent of the agent is to move
+vector<OthelloBoard> benchPositions() {
+    vector<OthelloBoard> positions;
+    OthelloBoard board(BENCH_EDGE_SIZE);
+    for (int ply = 0; (int)positions.size() < BENCH_POSITIONS &&
+                      !board.isGameOver(); ++ply) {
+        board.exploreMoves();
+        if (ply % BENCH_PLY_STEP == BENCH_PLY_STEP - 1) {
+            positions.push_back(board);
+        }
+        board.move(board.greedy());
+    }
+    return positions;
+}
+
+int bench(int depth, int ponderMs) {
+    AgentSpec spec;
+    AgentSpec::parse("search:" + to_string(depth) + ":0", spec);
+    double cold = 0, warm = 0;
+    for (OthelloBoard &position: benchPositions()) {
+        // The opponent answers greedily
+        OthelloBoard reply = position;
+        reply.exploreMoves();
+        reply.move(reply.greedy());
+
+        double seconds;
+        AsyncAgent fresh(spec, BENCH_EDGE_SIZE);
+        fresh.think(reply);
+        waitMove(fresh, 1 << 30, seconds);
+        cold += seconds;
+
+        AsyncAgent pondering(spec, BENCH_EDGE_SIZE);
+        pondering.ponder(position);
+        this_thread::sleep_for(milliseconds(ponderMs));
+        pondering.think(reply);
+        waitMove(pondering, 1 << 30, seconds);
+        warm += seconds;
+        cout << reply.getPosition() << ": " << cold << " s cold, " << warm
+             << " s after pondering so far" << endl;
+    }
+    cout << "depth " << depth << ": " << cold << " s without pondering, "
+         << warm << " s after " << ponderMs << " ms of pondering a move"
+         << endl;
+    return 0;
+}
+
+int check() {
+    int failures = 0;
+    OthelloBoard board(BENCH_EDGE_SIZE);
+    board.exploreMoves();
+    double seconds;
+    auto fail = [&](const string &what) {
+        ++failures;
+        cout << "FAIL " << what << endl;
+    };
+
+    // A quick agent gives the move it gives without a thread
+    AgentSpec quick;
+    AgentSpec::parse("search:4:0", quick);
+    AsyncAgent async(quick, BENCH_EDGE_SIZE);
+    OthelloBoard copy = board;
+    Agent sync(quick, copy);
+    async.think(board);
+    if (waitMove(async, CHECK_TIMEOUT_MS * 10, seconds) != sync.getMove()) {
+        fail("asynchronous and synchronous moves differ");
+    }
+
+    // A deep search stops when forced, and pondering does not stop it
+    AgentSpec deep;
+    AgentSpec::parse(CHECK_DEEP, deep);
+    AsyncAgent forced(deep, BENCH_EDGE_SIZE);
+    forced.ponder(board);
+    this_thread::sleep_for(milliseconds(50));
+    forced.forceMove();
+    forced.think(board);
+    this_thread::sleep_for(milliseconds(50));
+    if (!forced.isThinking()) {
+        fail("not thinking");
+    }
+    forced.forceMove();
+    int move = waitMove(forced, CHECK_TIMEOUT_MS, seconds);
+    if (!board.getMoves().contains(move)) {
+        fail("forced move " + to_string(move) + " after " +
+             to_string(seconds) + " s");
+    }
+
+    // Cancelled, nothing comes out; a new move afterwards does
+    forced.think(board);
+    this_thread::sleep_for(milliseconds(50));
+    forced.cancel();
+    this_thread::sleep_for(milliseconds(100));
+    if (forced.poll(move) || forced.isThinking()) {
+        fail("cancelled move");
+    }
+    forced.think(board);
+    forced.forceMove(); // before the worker even starts
+    move = waitMove(forced, CHECK_TIMEOUT_MS, seconds);
+    if (!board.getMoves().contains(move)) {
+        fail("move after a cancel");
+    }
+
+    // Destroyed while thinking
+    auto start = steady_clock::now();
+    {
+        AsyncAgent busy(deep, BENCH_EDGE_SIZE);
+        busy.think(board);
+        this_thread::sleep_for(milliseconds(50));
+    }
+    seconds = duration<double>(steady_clock::now() - start).count();
+    if (seconds * 1000 > CHECK_TIMEOUT_MS) {
+        fail("destroyed in " + to_string(seconds) + " s");
+    }
+
+    cout << failures << " failures" << endl;
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc > 1 && string(argv[1]) == "check") {
+        return check();
+    }
+    int depth = argc > 1 ? atoi(argv[1]) : BENCH_DEPTH;
+    int ponderMs = argc > 2 ? atoi(argv[2]) : BENCH_PONDER_MS;
+    if (depth <= 0 || ponderMs < 0) {
+        cerr << "Usage: ponder [DEPTH] [PONDER_MS]" << endl;
+        cerr << "       ponder check" << endl;
+        return 1;
+    }
+    return bench(depth, ponderMs);
+}
@@ -0,0 +1,153 @@
+// Per-move engine report of one game: where the time went, nodes,
+// evaluations, table hits and branching factor of each move.
+// Usage: profile [AGENT1] [AGENT2] [EDGE_SIZE] [OUTPUT]   AGENT1 plays
+//                                       black; OUTPUT.json or OUTPUT.csv
+//                                       gets the moves of both
+//        profile check                  records of a game and their export
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Agent.hpp"
+#include "Board.hpp"
+#include "Stats.hpp"
+
+using namespace std;
+
+#define PROFILE_AGENT1 "search:6"
+#define PROFILE_AGENT2 "mcts:2000"
+#define PROFILE_EDGE_SIZE 8
+
+// The moves of both agents in the order they were played
+GameStats playGame(const AgentSpec &first, const AgentSpec &second,
+                   int edgeSize, int &plies) {
+    OthelloBoard board(edgeSize);
+    Agent black(first, board, false, 1);
+    Agent white(second, board, false, 2);
+    GameStats game;
+    plies = 0;
+    size_t blackSeen = 0, whiteSeen = 0;
+    while (!board.isGameOver()) {
+        board.exploreMoves();
+        bool blackToMove = board.getPlayer() == BLACK;
+        Agent &agent = blackToMove ? black : white;
+        board.move(agent.getMove());
+        ++plies;
+        // Both agents record into their own stats, the last one is new
+        size_t &seen = blackToMove ? blackSeen : whiteSeen;
+        const vector<MoveReport> &moves = agent.getStats().getMoves();
+        for (; seen < moves.size(); ++seen) {
+            game.add(moves[seen]);
+        }
+    }
+    return game;
+}
+
+int count(const string &text, const string &what) {
+    int found = 0;
+    for (size_t at = text.find(what); at != string::npos;
+         at = text.find(what, at + 1)) {
+        ++found;
+    }
+    return found;
+}
+
+int check() {
+    int failures = 0;
+    auto fail = [&](const string &what) {
+        ++failures;
+        cout << "FAIL " << what << endl;
+    };
+    AgentSpec first, second;
+    AgentSpec::parse("search:4", first);
+    AgentSpec::parse("mcts:300", second);
+    int plies;
+    GameStats game = playGame(first, second, 8, plies);
+    const vector<MoveReport> &moves = game.getMoves();
+
+    if (!STATS_ENABLED) {
+        if (!moves.empty()) {
+            fail("moves recorded without OTHELLO_STATS");
+        }
+        cout << "built without OTHELLO_STATS, nothing recorded" << endl;
+    } else if ((int)moves.size() != plies) {
+        fail(to_string(moves.size()) + " records of " + to_string(plies) +
+             " moves");
+    }
+    int searched = 0, solved = 0;
+    for (const MoveReport &move: moves) {
+        string where = " at " + to_string(move.empties) + " empties";
+        if (move.ttHits > move.ttProbes || move.thinkSeconds < 0) {
+            fail("inconsistent counters" + where);
+        }
+        if (move.phase == "search") {
+            ++searched;
+            if (move.nodes <= 0 || move.expanded <= 0 ||
+                move.evaluations <= 0 || move.ttProbes <= 0 ||
+                move.depth != 4 || move.branching() < 1) {
+                fail("search counters missing" + where);
+            }
+        } else if (move.phase == "endgame") {
+            ++solved;
+            if (move.nodes <= 0 || move.depth != move.empties) {
+                fail("endgame counters missing" + where);
+            }
+        } else if (move.phase == "mcts") {
+            // Fewer playouts when there is one move to play
+            if (move.nodes > 300 || move.player != WHITE) {
+                fail("mcts counters wrong" + where);
+            }
+        } else {
+            fail("phase " + move.phase + where);
+        }
+    }
+    if (STATS_ENABLED && (!searched || !solved)) {
+        fail("no search or endgame move");
+    }
+
+    // One object per move, one line per move and a header
+    ostringstream json, csv;
+    game.writeJSON(json);
+    game.writeCSV(csv);
+    if (count(json.str(), "{\"empties\"") != (int)moves.size() ||
+        count(csv.str(), "\n") != (int)moves.size() + 1) {
+        fail("export of " + to_string(moves.size()) + " moves");
+    }
+
+    cout << moves.size() << " moves recorded, " << failures << " failures"
+         << endl;
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc > 1 && string(argv[1]) == "check") {
+        return check();
+    }
+    AgentSpec first, second;
+    const char *firstName = argc > 1 ? argv[1] : PROFILE_AGENT1;
+    const char *secondName = argc > 2 ? argv[2] : PROFILE_AGENT2;
+    int edgeSize = argc > 3 ? atoi(argv[3]) : PROFILE_EDGE_SIZE;
+    if (!AgentSpec::parse(firstName, first) || first.strategy == HUMAN ||
+        !AgentSpec::parse(secondName, second) || second.strategy == HUMAN ||
+        edgeSize < MINIMUM_OTHELLO_BOARD_SIZE ||
+        edgeSize > MAXIMUM_OTHELLO_BOARD_SIZE) {
+        cerr << "Usage: profile [AGENT1] [AGENT2] [EDGE_SIZE] [OUTPUT]"
+             << endl;
+        cerr << "       profile check" << endl;
+        return 1;
+    }
+    if (!STATS_ENABLED) {
+        cerr << "Built without OTHELLO_STATS, nothing to report" << endl;
+        return 1;
+    }
+    int plies;
+    GameStats game = playGame(first, second, edgeSize, plies);
+    cout << firstName << " (black) against " << secondName << " on "
+         << edgeSize << "x" << edgeSize << endl;
+    game.print();
+    if (argc > 4 && !game.save(argv[4])) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,279 @@
+// Self-play training data: every position of every game, the move played
+// from it and the final score, streamed to a chunked game file.
+// Usage: selfplay write OUTPUT [GAMES] [AGENT] [EDGE_SIZE] [THREADS] [zlib]
+//                                   appends GAMES games, the first PLIES
+//                                   moves random, AGENT plays the rest
+//        selfplay read INPUT        counts the games and checks the file
+//        selfplay check             write and read round trips, damaged
+//                                   files and appending to a cut one
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "Agent.hpp"
+#include "Board.hpp"
+#include "GameData.hpp"
+
+using namespace std;
+using namespace chrono;
+
+#define SELFPLAY_GAMES 1000
+#define SELFPLAY_AGENT "search:3:10"
+#define SELFPLAY_EDGE_SIZE 8
+#define SELFPLAY_RANDOM_PLIES 6 // so that games differ
+#define CHECK_PATH "/tmp/selfplay_check.bin"
+#define CHECK_CHUNK_BYTES 4096 // many chunks out of few games
+
+// Plays one game from the start of board, agent after the random plies
+void playGame(OthelloBoard &board, Agent &agent, const string &start,
+              unsigned seed, GameRecord &record) {
+    board.setPosition(start);
+    record.clear(board.getEdgeSize());
+    minstd_rand rng(seed);
+    for (int ply = 0; !board.isGameOver(); ++ply) {
+        board.exploreMoves();
+        int move = ply < SELFPLAY_RANDOM_PLIES ? board.random(rng())
+                                               : agent.getMove();
+        record.add(board, move);
+        board.move(move);
+    }
+    record.score = board.score();
+}
+
+int writeGames(int argc, char const *argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: selfplay write OUTPUT [GAMES] [AGENT] [EDGE_SIZE] "
+             << "[THREADS] [zlib]" << endl;
+        return 1;
+    }
+    string path = argv[2];
+    int nGames = argc > 3 ? atoi(argv[3]) : SELFPLAY_GAMES;
+    AgentSpec spec;
+    if (!AgentSpec::parse(argc > 4 ? argv[4] : SELFPLAY_AGENT, spec) ||
+        spec.strategy == HUMAN) {
+        cerr << "Invalid agent " << argv[4] << endl;
+        return 1;
+    }
+    int edgeSize = argc > 5 ? atoi(argv[5]) : SELFPLAY_EDGE_SIZE;
+    int threads = argc > 6 ? atoi(argv[6]) : thread::hardware_concurrency();
+    threads = max(threads, 1);
+    bool compress = argc > 7 && string(argv[7]) == "zlib";
+    if (compress && !GameWriter::canCompress()) {
+        cerr << "Built without zlib, writing uncompressed" << endl;
+    }
+
+    GameWriter writer;
+    if (!writer.open(path, compress)) {
+        return 1;
+    }
+    auto start = steady_clock::now();
+    atomic<int> nextGame(0);
+    atomic<long long> positions(0), writeNanos(0);
+    // One board and agent per thread, as in bookgen
+    auto worker = [&](int id) {
+        OthelloBoard board(edgeSize);
+        string startPosition = board.getPosition();
+        Agent agent(spec, board, false, id);
+        GameRecord record;
+        for (int game = nextGame++; game < nGames; game = nextGame++) {
+            playGame(board, agent, startPosition, game, record);
+            auto before = steady_clock::now();
+            writer.write(record);
+            writeNanos += duration_cast<nanoseconds>(steady_clock::now() -
+                                                     before).count();
+            positions += record.plies();
+        }
+    };
+    vector<thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(worker, i);
+    }
+    for (auto &th: pool) {
+        th.join();
+    }
+    double playSeconds = duration<double>(steady_clock::now() - start).count();
+    if (!writer.close()) {
+        return 1;
+    }
+
+    cout << nGames << " games, " << positions << " positions in "
+         << playSeconds << " s (" << positions / playSeconds
+         << " positions/s)" << endl;
+    cout << writer.getChunks() << " chunks, " << writer.getRawBytes()
+         << " bytes of records stored in " << writer.getStoredBytes()
+         << endl;
+    cout << "game threads spent " << writeNanos / 1e6 << " ms in write()"
+         << endl;
+    return 0;
+}
+
+int readGames(const char *path) {
+    GameReader reader;
+    if (!reader.open(path)) {
+        return 1;
+    }
+    GameRecord record;
+    long long games = 0, positions = 0, blackWins = 0, draws = 0;
+    while (reader.next(record)) {
+        ++games;
+        positions += record.plies();
+        blackWins += record.score > 0;
+        draws += record.score == 0;
+    }
+    cout << games << " games, " << positions << " positions, black wins "
+         << blackWins << ", draws " << draws << ", white wins "
+         << games - blackWins - draws << endl;
+    return reader.isCorrupt() ? 1 : 0;
+}
+
+// Random games on a few board sizes, quick to play
+vector<GameRecord> checkGames(int count) {
+    vector<GameRecord> games(count);
+    AgentSpec spec;
+    AgentSpec::parse("random", spec);
+    for (int i = 0; i < count; ++i) {
+        OthelloBoard board(6 + 2 * (i % 3));
+        Agent agent(spec, board, false, i);
+        playGame(board, agent, board.getPosition(), i, games[i]);
+    }
+    return games;
+}
+
+// Reads path back, the count first games must match games
+bool readsBack(const vector<GameRecord> &games, size_t count,
+               bool expectCorrupt) {
+    GameReader reader;
+    if (!reader.open(CHECK_PATH)) {
+        return false;
+    }
+    GameRecord record;
+    size_t read = 0;
+    while (reader.next(record)) {
+        if (read >= games.size() || !(record == games[read])) {
+            cout << "FAIL game " << read << " differs" << endl;
+            return false;
+        }
+        ++read;
+    }
+    if (expectCorrupt ? read >= count || !reader.isCorrupt()
+                      : read != count || reader.isCorrupt()) {
+        cout << "FAIL read " << read << " of " << count << " games" << endl;
+        return false;
+    }
+    return true;
+}
+
+int check() {
+    vector<GameRecord> games = checkGames(60);
+    int failures = 0;
+    for (bool compress: {false, true}) {
+        // Two sessions appending to one file
+        remove(CHECK_PATH);
+        for (size_t half: {(size_t)0, games.size() / 2}) {
+            GameWriter writer;
+            if (!writer.open(CHECK_PATH, compress, CHECK_CHUNK_BYTES)) {
+                return 1;
+            }
+            for (size_t i = half; i < half + games.size() / 2; ++i) {
+                writer.write(games[i]);
+            }
+            writer.close();
+        }
+        failures += !readsBack(games, games.size(), false);
+
+        // Replayed, the moves lead to the recorded positions
+        for (const GameRecord &record: games) {
+            OthelloBoard board(record.edgeSize);
+            vector<char> cells;
+            for (int ply = 0; ply < record.plies(); ++ply) {
+                record.position(ply, cells);
+                if (cells != board.getCells() ||
+                    record.players[ply] != board.getPlayer()) {
+                    cout << "FAIL position " << ply << " differs" << endl;
+                    ++failures;
+                    break;
+                }
+                board.exploreMoves();
+                board.move(record.moves[ply]);
+            }
+        }
+
+        // One flipped byte loses its chunk and those after it, a cut
+        // stops at the last whole chunk
+        fstream file(CHECK_PATH, ios::in | ios::out | ios::binary);
+        file.seekg(0, ios::end);
+        long long size = file.tellg();
+        file.seekg(size / 2);
+        char byte = file.get();
+        file.seekp(size / 2);
+        file.put(byte ^ 0x10);
+        file.close();
+        failures += !readsBack(games, games.size(), true);
+
+        file.open(CHECK_PATH, ios::in | ios::out | ios::binary);
+        file.seekp(size / 2);
+        file.put(byte);
+        file.close();
+        if (truncate(CHECK_PATH, size - 1) != 0) {
+            return 1;
+        }
+        failures += !readsBack(games, games.size(), true);
+
+        // Appending after the cut drops the partial chunk, the new games
+        // follow the whole ones
+        GameReader reader;
+        GameRecord record;
+        size_t kept = 0;
+        if (reader.open(CHECK_PATH)) {
+            while (reader.next(record)) {
+                ++kept;
+            }
+        }
+        vector<GameRecord> expected(games.begin(), games.begin() + kept);
+        GameWriter writer;
+        if (!writer.open(CHECK_PATH, compress, CHECK_CHUNK_BYTES)) {
+            return 1;
+        }
+        for (size_t i = 0; i < 10; ++i) {
+            writer.write(games[i]);
+            expected.push_back(games[i]);
+        }
+        writer.close();
+        failures += !readsBack(expected, expected.size(), false);
+        if (!GameWriter::canCompress()) {
+            break;
+        }
+    }
+    remove(CHECK_PATH);
+
+    cout << games.size() << " games"
+         << (GameWriter::canCompress() ? "" : " (no zlib, raw only)") << ", "
+         << failures << " failures" << endl;
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+    if (mode == "write") {
+        return writeGames(argc, argv);
+    }
+    if (mode == "read" && argc > 2) {
+        return readGames(argv[2]);
+    }
+    if (mode == "check") {
+        return check();
+    }
+    cerr << "Usage: selfplay write OUTPUT [GAMES] [AGENT] [EDGE_SIZE] "
+         << "[THREADS] [zlib]" << endl;
+    cerr << "       selfplay read INPUT" << endl;
+    cerr << "       selfplay check" << endl;
+    return 1;
+}
@@ -0,0 +1,47 @@
+// Many games in one process, for game hosts without a display: the server
+// of include/Server.hpp on a Unix socket or on stdin and stdout.
+// Usage: serve [EDGE_SIZE] [THREADS] [SOCKET]   EDGE_SIZE of new games by
+//                                               default, SOCKET - for stdin
+//                                               and stdout
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "Board.hpp"
+#include "OpeningBook.hpp"
+#include "PatternEval.hpp"
+#include "Server.hpp"
+
+using namespace std;
+
+#define SERVE_EDGE_SIZE 8
+
+int main(int argc, char const *argv[]) {
+    int edgeSize = argc > 1 ? atoi(argv[1]) : SERVE_EDGE_SIZE;
+    int threads = argc > 2 ? atoi(argv[2]) : thread::hardware_concurrency();
+    string path = argc > 3 ? argv[3] : SERVER_DEFAULT_SOCKET;
+    if (!OthelloBoard::supports(edgeSize) || threads < 0) {
+        cerr << "Usage: serve [EDGE_SIZE] [THREADS] [SOCKET]" << endl;
+        cerr << "Plays games on EDGE_SIZE boards by default, for the clients "
+             << "of SOCKET (" << SERVER_DEFAULT_SOCKET << " by default) or "
+             << "of - for stdin and stdout, searching on THREADS threads"
+             << endl;
+        cerr << "Agents open from $OTHELLO_BOOK or " << BOOK_DEFAULT_PATH
+             << " and search agents evaluate with $OTHELLO_WEIGHTS or "
+             << PATTERN_DEFAULT_PATH << " if there are" << endl;
+        return 1;
+    }
+    OpeningBook book;
+    book.loadDefault();
+    PatternEval eval;
+    eval.loadDefault();
+    // Runs until killed, or until stdin ends when serving it
+    Server server(edgeSize, max(threads, 1), &book, &eval);
+    if (path == "-") {
+        server.serve(STDIN_FILENO, STDOUT_FILENO);
+        return 0;
+    }
+    cerr << "Serving on " << path << endl;
+    return server.listen(path) ? 0 : 1;
+}
@@ -0,0 +1,324 @@
+// Many games in one process: the server driven through a pipe the way a
+// client drives it through its socket.
+// Usage: server [GAMES] [THREADS] [AGENT]   plays GAMES games at once with
+//                                           AGENT on both sides, on a pool
+//                                           of THREADS threads
+//        server check                       protocol, errors, budgets and
+//                                           the end of the input
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "Board.hpp"
+#include "Server.hpp"
+
+using namespace std;
+using namespace chrono;
+
+#define BENCH_GAMES 200
+#define BENCH_AGENT "search:4"
+#define BENCH_EDGE_SIZE 8
+#define CHECK_GAMES 24
+#define CHECK_BUDGET_MS 1500 // of a game that could search forever
+#define CHECK_BUDGET_SLACK_MS 500
+
+// The client's end of a server serving on two pipes
+class Connection
+{
+    int toServer, fromServer;
+    string buffer;
+    thread serving;
+
+public:
+    Connection(Server &server) {
+        int in[2], out[2];
+        if (pipe(in) != 0 || pipe(out) != 0) {
+            cerr << "Cannot create pipes" << endl;
+            exit(1);
+        }
+        toServer = in[1];
+        fromServer = out[0];
+        serving = thread([&server, in, out] {
+            server.serve(in[0], out[1]);
+            close(in[0]);
+            close(out[1]);
+        });
+    }
+    ~Connection() {
+        closeInput();
+        serving.join();
+        close(fromServer);
+    }
+
+    // As a client piping its commands in does once they are all sent
+    void closeInput() {
+        if (toServer >= 0) {
+            close(toServer);
+            toServer = -1;
+        }
+    }
+
+    void send(const string &line) {
+        string data = line + "\n";
+        ssize_t n = write(toServer, data.data(), data.size());
+        if (n != (ssize_t)data.size()) {
+            cerr << "Cannot write to the server" << endl;
+            exit(1);
+        }
+    }
+    // false once the server is done
+    bool receive(string &line) {
+        char chunk[SERVER_READ_BYTES];
+        size_t end;
+        while ((end = buffer.find('\n')) == string::npos) {
+            ssize_t n = read(fromServer, chunk, sizeof(chunk));
+            if (n <= 0) {
+                return false;
+            }
+            buffer.append(chunk, n);
+        }
+        line = buffer.substr(0, end);
+        buffer.erase(0, end + 1);
+        return true;
+    }
+    string ask(const string &line) {
+        string reply;
+        send(line);
+        receive(reply);
+        return reply;
+    }
+};
+
+// A game as the client sees it
+struct ClientGame
+{
+    OthelloBoard board;
+    bool answers; // the client plays one side with random moves
+    int sent; // the client's move until the server accepts it
+    bool over;
+
+    ClientGame(int edgeSize, bool answers)
+        : board(edgeSize), answers(answers), sent(PASSING_MOVE - 1),
+          over(false) {
+        board.exploreMoves();
+    }
+};
+
+// Plays the games to their end, the server's agent moving unless the
+// client answers it; returns the failures
+int playAll(Connection &connection, map<string, ClientGame> &games,
+            unsigned seed) {
+    int failures = 0, running = games.size();
+    minstd_rand rng(seed);
+    for (auto &entry: games) {
+        connection.send("go " + entry.first);
+    }
+    string line;
+    while (running > 0 && connection.receive(line)) {
+        istringstream in(line);
+        string kind, id;
+        int value;
+        in >> kind >> id >> value;
+        auto found = games.find(id);
+        if (found == games.end()) {
+            cout << "FAIL unexpected reply " << line << endl;
+            return failures + 1;
+        }
+        ClientGame &game = found->second;
+        OthelloBoard &board = game.board;
+        if ((kind == "ok" || kind == "over") && game.sent >= PASSING_MOVE) {
+            board.move(game.sent);
+            board.exploreMoves();
+            game.sent = PASSING_MOVE - 1;
+        }
+        if (kind == "over") {
+            if (!board.isGameOver() || value != board.score()) {
+                cout << "FAIL " << line << " at " << board.getPosition()
+                     << endl;
+                ++failures;
+            }
+            game.over = true;
+            --running;
+            continue;
+        }
+        if (kind == "move") {
+            MoveList &moves = board.getMoves();
+            if (!moves.contains(value) &&
+                (value != PASSING_MOVE || !moves.empty())) {
+                cout << "FAIL illegal " << line << " at "
+                     << board.getPosition() << endl;
+                return failures + 1;
+            }
+            board.move(value);
+            board.exploreMoves();
+            if (game.answers && !board.isGameOver()) {
+                game.sent = board.random(rng());
+                connection.send("play " + id + " " + to_string(game.sent));
+                continue;
+            }
+        } else if (kind != "ok") {
+            cout << "FAIL " << line << endl;
+            return failures + 1;
+        }
+        connection.send("go " + id);
+    }
+    return failures;
+}
+
+int check() {
+    int failures = 0;
+    auto expect = [&](const string &reply, const string &wanted) {
+        if (reply != wanted) {
+            ++failures;
+            cout << "FAIL got \"" << reply << "\" instead of \"" << wanted
+                 << "\"" << endl;
+        }
+    };
+
+    {
+        Server server(BENCH_EDGE_SIZE, 2);
+        Connection connection(server);
+        expect(connection.ask("go nope"), "error nope unknown game");
+        expect(connection.ask("new a human"), "error a unknown agent");
+        expect(connection.ask("new a greedy 40"),
+               "error a invalid board size or time");
+        expect(connection.ask("new a greedy 6"), "ok a");
+        expect(connection.ask("new a greedy"), "error a game exists");
+        expect(connection.ask("play a 0"), "error a illegal move");
+        expect(connection.ask("jump a"), "error a unknown command");
+        expect(connection.ask("quitx a"), "error a unknown command");
+        expect(connection.ask("show a"), "board a ....../....../..ox../"
+               "..xo../....../...... x");
+        expect(connection.ask("close a"), "ok a");
+
+        // Games of all sorts at once; in a third of them the client plays
+        // randomly against the server's agent
+        const char *agents[] = {"random", "greedy", "search:3", "mcts:200"};
+        map<string, ClientGame> games;
+        for (int i = 0; i < CHECK_GAMES; ++i) {
+            string id = "g" + to_string(i);
+            int size = 6 + 2 * (i % 2);
+            bool answers = i % 3 == 0;
+            games.emplace(id, ClientGame(size, answers));
+            expect(connection.ask("new " + id + " " + agents[i % 4] + " " +
+                                  to_string(size)), "ok " + id);
+        }
+        expect(connection.ask("stats"),
+               "stats " + to_string(CHECK_GAMES) + " 0 0");
+        failures += playAll(connection, games, 1);
+        for (auto &entry: games) {
+            expect(connection.ask("show " + entry.first), "board " +
+                   entry.first + " " + entry.second.board.getPosition());
+            expect(connection.ask("go " + entry.first), "over " +
+                   entry.first + " " + to_string(entry.second.board.score()));
+        }
+        expect(connection.ask("close g0"), "ok g0");
+        expect(connection.ask("close g0"), "error g0 unknown game");
+        // Once the server has let go of the client
+        string line;
+        connection.send("quit");
+        if (connection.receive(line) || server.getSessions() != 0) {
+            cout << "FAIL " << server.getSessions()
+                 << " games left after quit" << endl;
+            ++failures;
+        }
+    }
+
+    // The move asked for last is still sent once the input ends
+    {
+        Server server(BENCH_EDGE_SIZE, 1);
+        Connection connection(server);
+        expect(connection.ask("new e search:4"), "ok e");
+        connection.send("go e");
+        connection.closeInput();
+        string line;
+        expect(connection.receive(line) ? line.substr(0, 7) : "", "move e ");
+        if (connection.receive(line)) {
+            expect(line, "");
+        }
+    }
+
+    // A game that could search forever keeps to its budget
+    {
+        Server server(BENCH_EDGE_SIZE, 1);
+        Connection connection(server);
+        map<string, ClientGame> games;
+        games.emplace("t", ClientGame(6, false));
+        expect(connection.ask("new t search:60:0 6 " +
+                              to_string(CHECK_BUDGET_MS)), "ok t");
+        auto start = steady_clock::now();
+        failures += playAll(connection, games, 2);
+        double ms = duration<double, milli>(steady_clock::now() -
+                                            start).count();
+        if (ms > CHECK_BUDGET_MS + CHECK_BUDGET_SLACK_MS) {
+            cout << "FAIL game took " << ms << " ms of "
+                 << CHECK_BUDGET_MS << endl;
+            ++failures;
+        }
+        cout << "game with a " << CHECK_BUDGET_MS << " ms budget took "
+             << ms << " ms" << endl;
+    }
+
+    cout << failures << " failures" << endl;
+    cout << (failures ? "FAILED" : "OK") << endl;
+    return failures ? 1 : 0;
+}
+
+// Resident memory of this process in kB, 0 if unknown
+long residentKB() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return atol(line.c_str() + 6);
+        }
+    }
+    return 0;
+}
+
+int bench(int nGames, int threads, const string &agent) {
+    Server server(BENCH_EDGE_SIZE, threads);
+    Connection connection(server);
+    map<string, ClientGame> games;
+    for (int i = 0; i < nGames; ++i) {
+        string id = to_string(i);
+        games.emplace(id, ClientGame(BENCH_EDGE_SIZE, false));
+        string reply = connection.ask("new " + id + " " + agent);
+        if (reply != "ok " + id) {
+            cerr << reply << endl;
+            return 1;
+        }
+    }
+    auto start = steady_clock::now();
+    int failures = playAll(connection, games, 0);
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    long kb = residentKB();
+    cout << nGames << " games of " << agent << " on " << threads
+         << " threads: " << seconds << " s, " << server.getSearches() / seconds
+         << " moves/s" << endl;
+    cout << "resident memory " << kb / 1024.0 << " MB, "
+         << kb / (double)nGames << " kB a game" << endl;
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc > 1 && string(argv[1]) == "check") {
+        return check();
+    }
+    int nGames = argc > 1 ? atoi(argv[1]) : BENCH_GAMES;
+    int threads = argc > 2 ? atoi(argv[2]) : thread::hardware_concurrency();
+    string agent = argc > 3 ? argv[3] : BENCH_AGENT;
+    if (nGames <= 0 || threads <= 0) {
+        cerr << "Usage: server [GAMES] [THREADS] [AGENT]" << endl;
+        cerr << "       server check" << endl;
+        return 1;
+    }
+    return bench(nGames, threads, agent);
+}
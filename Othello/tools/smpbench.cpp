@@ -0,0 +1,72 @@
+// Lazy SMP speedup against one thread at a fixed depth.
+// Usage: smpbench [DEPTH] [MAX_THREADS]
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "Board.hpp"
+#include "Search.hpp"
+
+using namespace std;
+
+#define BENCH_EDGE_SIZE 8
+#define BENCH_DEPTH 8
+#define BENCH_PLY_STEP 4 // plies between two benchmark positions
+#define BENCH_POSITIONS 8
+
+// Positions reached by greedy self-play from the start, a fixed and
+// reproducible mix of opening and middle game
+vector<OthelloBoard> standardPositions() {
+    vector<OthelloBoard> positions;
+    OthelloBoard board(BENCH_EDGE_SIZE);
+    for (int ply = 0; (int)positions.size() < BENCH_POSITIONS &&
+                      !board.isGameOver(); ++ply) {
+        board.exploreMoves();
+        if (ply % BENCH_PLY_STEP == 0) {
+            positions.push_back(board);
+        }
+        board.move(board.greedy());
+    }
+    return positions;
+}
+
+int main(int argc, char const *argv[]) {
+    int depth = argc > 1 ? atoi(argv[1]) : BENCH_DEPTH;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : thread::hardware_concurrency();
+    maxThreads = max(maxThreads, 1);
+
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    vector<OthelloBoard> positions = standardPositions();
+    TranspositionTable table;
+    cout << positions.size() << " positions at depth " << depth << endl;
+    cout << setw(8) << "threads" << setw(12) << "seconds" << setw(14)
+         << "nodes" << setw(14) << "nodes/s" << setw(10) << "speedup"
+         << endl;
+
+    double baseline = 0;
+    for (int threads: threadCounts) {
+        double seconds = 0;
+        long long nodes = 0;
+        for (auto &position: positions) {
+            table.clear();
+            Search search(depth, 0, &table, threads);
+            search.bestMove(position);
+            seconds += search.getElapsed();
+            nodes += search.getNodes();
+        }
+        if (threads == 1) {
+            baseline = seconds;
+        }
+        cout << setw(8) << threads << setw(12) << fixed << setprecision(3)
+             << seconds << setw(14) << nodes << setw(14)
+             << (long long)(nodes / seconds) << setw(9) << setprecision(2)
+             << baseline / seconds << "x" << endl;
+    }
+    return 0;
+}